@@ -0,0 +1,91 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <string>
+
+// Generates benchmark inputs of roughly the requested size. The generator
+// is seeded identically on every run so that results stay comparable.
+class Corpus {
+public:
+    enum Kind {FlatMap, LongSequence, NumberHeavy, UnicodeHeavy, Commented};
+
+    static std::string generate(Kind kind, size_t bytes) {
+        Corpus corpus;
+        std::string data;
+        data.reserve(bytes + 64);
+        for (size_t line = 0; data.size() < bytes; line++) {
+            if (line > 0) {
+                data.push_back('\n');
+            }
+            switch (kind) {
+            case FlatMap:
+                data.append("key").append(number(line)).append(": ");
+                corpus.word(data, 4 + corpus.next() % 12);
+                break;
+            case LongSequence:
+                data.append("- ");
+                corpus.word(data, 4 + corpus.next() % 12);
+                break;
+            case NumberHeavy:
+                data.append("n").append(number(line)).append(": ").append(number(corpus.next() % 1000000));
+                break;
+            case UnicodeHeavy:
+                data.append("avain").append(number(line)).append(": ");
+                corpus.unicodeWord(data, 4 + corpus.next() % 12);
+                break;
+            case Commented:
+                data.append("# ");
+                corpus.word(data, 20 + corpus.next() % 40);
+                data.append("\n  # ");
+                corpus.word(data, 20 + corpus.next() % 40);
+                data.append("\nkey").append(number(line)).append(": ");
+                corpus.word(data, 4 + corpus.next() % 12);
+                data.append(" # ");
+                corpus.word(data, 8);
+                break;
+            }
+        }
+        return data;
+    }
+
+    static const char* name(Kind kind) {
+        static const char* names[] = {"flat_map", "long_sequence", "number_heavy", "unicode_heavy", "commented"};
+        return names[kind];
+    }
+
+private:
+    Corpus() : state(12345) {}
+
+    unsigned int next() {
+        state = state * 1103515245u + 12345u;
+        return (state >> 16) & 0x7fff;
+    }
+
+    void word(std::string& out, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            out.push_back(static_cast<char>('a' + next() % 26));
+        }
+    }
+
+    void unicodeWord(std::string& out, size_t length) {
+        static const char* letters[] = {"a", "s", "t", "\xc3\xa4", "\xc3\xb6", "\xc3\xa5", "\xc3\x84", "\xc3\x96"};
+        for (size_t i = 0; i < length; i++) {
+            out.append(letters[next() % 8]);
+        }
+    }
+
+    static std::string number(size_t value) {
+        char buffer[24];
+        char* p = buffer + sizeof(buffer);
+        do {
+            *--p = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+        return std::string(p, buffer + sizeof(buffer));
+    }
+
+private:
+    unsigned int state;
+};
+
+#endif
@@ -0,0 +1,309 @@
+#define YAMLPP_COUNT_ALLOCATIONS
+#include <benchmark/benchmark.h>
+#include "yamlpp/Document.h"
+#include "yamlpp/Emitter.h"
+#include "yamlpp/JsonTranscoder.h"
+#include "yamlpp/Binary.h"
+#include "yamlpp/ParallelParser.h"
+#include "yamlpp/Compressed.h"
+#include "yamlpp/Patch.h"
+#include "Corpus.h"
+
+namespace {
+
+const size_t corpusSize = 1 << 20;
+
+const std::string& corpus(Corpus::Kind kind) {
+    static std::string corpora[5];
+    if (corpora[kind].empty()) {
+        corpora[kind] = Corpus::generate(kind, corpusSize);
+    }
+    return corpora[kind];
+}
+
+// Discards everything written to it, so that transcoding is measured
+// without the cost of growing an output string.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) {return c;}
+    std::streamsize xsputn(const char*, std::streamsize count) {return count;}
+};
+
+void BM_Parse(benchmark::State& state, Corpus::Kind kind) {
+    const std::string& data = corpus(kind);
+    AllocationCounter counter;
+    bool full = true;
+    for (auto _ : state) {
+        Document document;
+        full = document.parse(data).full && full;
+        benchmark::DoNotOptimize(document);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    state.counters["allocs/doc"] = double(counter.allocations) / state.iterations();
+    if (!full) {
+        state.SetLabel("partial parse");
+    }
+}
+BENCHMARK_CAPTURE(BM_Parse, flat_map, Corpus::FlatMap);
+BENCHMARK_CAPTURE(BM_Parse, long_sequence, Corpus::LongSequence);
+BENCHMARK_CAPTURE(BM_Parse, number_heavy, Corpus::NumberHeavy);
+BENCHMARK_CAPTURE(BM_Parse, unicode_heavy, Corpus::UnicodeHeavy);
+BENCHMARK_CAPTURE(BM_Parse, commented, Corpus::Commented);
+
+void BM_ParallelParse(benchmark::State& state, Corpus::Kind kind) {
+    const std::string& data = corpus(kind);
+    ParallelParser parser;
+    bool full = true;
+    for (auto _ : state) {
+        Document document;
+        full = parser.parse(data, document, data.size() / 16).full && full;
+        benchmark::DoNotOptimize(document);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    if (!full) {
+        state.SetLabel("partial parse");
+    }
+}
+BENCHMARK_CAPTURE(BM_ParallelParse, flat_map, Corpus::FlatMap);
+BENCHMARK_CAPTURE(BM_ParallelParse, long_sequence, Corpus::LongSequence);
+
+std::string gzip(const std::string& data) {
+    z_stream stream = z_stream();
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    std::string compressed(deflateBound(&stream, data.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = data.size();
+    stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+    stream.avail_out = compressed.size();
+    deflate(&stream, Z_FINISH);
+    compressed.resize(stream.total_out);
+    deflateEnd(&stream);
+    return compressed;
+}
+
+// Inflating everything before parsing against parsing as chunks are
+// inflated on another thread.
+void BM_CompressedParse(benchmark::State& state, bool streamed) {
+    const std::string& data = corpus(Corpus::FlatMap);
+    std::string compressed(gzip(data));
+    bool full = true;
+    for (auto _ : state) {
+        Document document;
+        GzipSource source(compressed.data(), compressed.size());
+        if (streamed) {
+            full = CompressedParser(document).parse(source) && full;
+        } else {
+            std::string inflated(data.size(), '\0');
+            inflated.resize(source.read(&inflated[0], inflated.size()));
+            full = document.parse(inflated).full && full;
+        }
+        benchmark::DoNotOptimize(document);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    if (!full) {
+        state.SetLabel("partial parse");
+    }
+}
+BENCHMARK_CAPTURE(BM_CompressedParse, inflate_first, false);
+BENCHMARK_CAPTURE(BM_CompressedParse, streamed, true);
+
+void BM_ParseInto(benchmark::State& state, Corpus::Kind kind) {
+    const std::string& data = corpus(kind);
+    Document document;
+    document.parse(data);
+    AllocationCounter counter;
+    for (auto _ : state) {
+        Document::parseInto(data, document);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    state.counters["allocs/doc"] = double(counter.allocations) / state.iterations();
+}
+BENCHMARK_CAPTURE(BM_ParseInto, flat_map, Corpus::FlatMap);
+BENCHMARK_CAPTURE(BM_ParseInto, long_sequence, Corpus::LongSequence);
+
+void BM_BlockScalar(benchmark::State& state, char style) {
+    std::string data("text: ");
+    data += style;
+    data += '\n';
+    while (data.size() < corpusSize) {
+        data += "  MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAu1SU1LfVLPHCozMxH2Mo4lgOEePzNm0tRgeLezV6ffAt0gunVTLw7onLRnrq0\n";
+    }
+    Document document;
+    for (auto _ : state) {
+        Document::parseInto(data, document);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK_CAPTURE(BM_BlockScalar, literal, '|');
+BENCHMARK_CAPTURE(BM_BlockScalar, folded, '>');
+
+void BM_ParseWithSchema(benchmark::State& state) {
+    const std::string& data = corpus(Corpus::FlatMap);
+    Schema schema;
+    schema.require("key0", Schema::String);
+    for (int i = 1; i < 1000; i++) {
+        schema.allow("key" + std::to_string(i), Schema::String);
+    }
+    CompiledSchema compiled(schema.compile());
+    Document document;
+    for (auto _ : state) {
+        document.reset();
+        document.parse(data, compiled);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ParseWithSchema);
+
+void BM_ValueAs(benchmark::State& state) {
+    Document document;
+    document.parse(corpus(Corpus::FlatMap));
+    std::vector<std::string> keys;
+    for (Document::const_iterator it = document.begin(); it != document.end(); it++) {
+        keys.push_back(it->first);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(document.valueAs<std::string>(keys[i++ % keys.size()]));
+    }
+}
+BENCHMARK(BM_ValueAs);
+
+void BM_MergedValueAs(benchmark::State& state) {
+    std::string data("base: &base {");
+    for (int i = 0; i < 1000; i++) {
+        data += (i ? ", key" : "key") + std::to_string(i) + ": value";
+    }
+    data += "}\n<<: *base";
+    Document document;
+    document.parse(data);
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back("key" + std::to_string(i));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(document.valueAs<const std::string&>(keys[i++ % keys.size()]).size());
+    }
+}
+BENCHMARK(BM_MergedValueAs);
+
+std::string sections(int changed) {
+    std::string data;
+    for (int i = 0; i < 100; i++) {
+        data += "section" + std::to_string(i) + ": {";
+        for (int j = 0; j < 1000; j++) {
+            data += (j ? ", key" : "key") + std::to_string(j) + (i == changed && j == 7 ? ": changed" : ": value");
+        }
+        data += "}\n";
+    }
+    return data;
+}
+
+// Two documents of large mappings that differ in a single entry. Once
+// their hashes are cached, the unchanged mappings are skipped whole.
+void BM_Diff(benchmark::State& state) {
+    Document before;
+    before.parse(sections(-1));
+    Document after;
+    after.parse(sections(50));
+    size_t changes = 0;
+    for (auto _ : state) {
+        changes = Diff::compare(before, after).size();
+    }
+    state.counters["changes"] = double(changes);
+}
+BENCHMARK(BM_Diff);
+
+// Changing one entry of a large document in place, where otherwise the
+// changed text would be parsed again.
+void BM_Patch(benchmark::State& state) {
+    Document document;
+    document.parse(sections(-1));
+    Patch change(Patch().replace("/section50/key7", "changed"));
+    Patch back(Patch().replace("/section50/key7", "value"));
+    for (auto _ : state) {
+        change.apply(document);
+        back.apply(document);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_Patch);
+
+void BM_MissingKey(benchmark::State& state, bool throwing) {
+    Document document;
+    document.parse(corpus(Corpus::FlatMap));
+    for (auto _ : state) {
+        int value = 0;
+        if (throwing) {
+            try {
+                value = document.valueAs<int>("missing");
+            } catch (const ScalarNotFoundException&) {
+            }
+        } else {
+            value = document.tryGet<int>("missing").value_or(0);
+        }
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK_CAPTURE(BM_MissingKey, valueAs, true);
+BENCHMARK_CAPTURE(BM_MissingKey, tryGet, false);
+
+void BM_ListIteration(benchmark::State& state) {
+    Document document;
+    document.parse(corpus(Corpus::LongSequence));
+    List& list = document.list();
+    for (auto _ : state) {
+        size_t length = 0;
+        for (size_t i = 0; i < list.count(); i++) {
+            length += list.valueAs<std::string>(i).size();
+        }
+        benchmark::DoNotOptimize(length);
+    }
+    state.SetItemsProcessed(state.iterations() * list.count());
+}
+BENCHMARK(BM_ListIteration);
+
+void BM_Emit(benchmark::State& state, Emitter::Style style, Corpus::Kind kind) {
+    Document document;
+    document.keepComments(true);
+    document.parse(corpus(kind));
+    Emitter emitter(style);
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        emitter.emit(document, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * out.size());
+}
+BENCHMARK_CAPTURE(BM_Emit, block, Emitter::Block, Corpus::FlatMap);
+BENCHMARK_CAPTURE(BM_Emit, block_commented, Emitter::Block, Corpus::Commented);
+BENCHMARK_CAPTURE(BM_Emit, flow_commented, Emitter::Flow, Corpus::Commented);
+
+void BM_JsonTranscode(benchmark::State& state) {
+    const std::string& data = corpus(Corpus::FlatMap);
+    NullBuffer buffer;
+    std::ostream sink(&buffer);
+    for (auto _ : state) {
+        JsonTranscoder(sink).transcode(data);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_JsonTranscode);
+
+void BM_CborEncode(benchmark::State& state) {
+    Document document;
+    document.parse(corpus(Corpus::FlatMap));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string encoded(Cbor::encode(document));
+        bytes += encoded.size();
+        benchmark::DoNotOptimize(encoded.data());
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_CborEncode);
+
+}
+
+BENCHMARK_MAIN();
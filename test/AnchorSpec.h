@@ -0,0 +1,90 @@
+#ifndef ANCHORSPEC_H
+#define ANCHORSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+#include "yamlpp/Emitter.h"
+#include "yamlpp/JsonTranscoder.h"
+
+using CppSpec::Specification;
+
+class AnchorSpec : public Specification<Document, AnchorSpec> {
+public:
+    AnchorSpec() {
+        REGISTER_BEHAVIOUR(AnchorSpec, aliasesGiveAnchoredValues);
+        REGISTER_BEHAVIOUR(AnchorSpec, aliasesShareTheAnchoredValue);
+        REGISTER_BEHAVIOUR(AnchorSpec, listItemsCanBeAnchorsAndAliases);
+        REGISTER_BEHAVIOUR(AnchorSpec, unknownAliasThrows);
+        REGISTER_BEHAVIOUR(AnchorSpec, aliasLimitIsEnforced);
+        REGISTER_BEHAVIOUR(AnchorSpec, aliasesAreEmittedAsValues);
+        REGISTER_BEHAVIOUR(AnchorSpec, aliasesAreTranscodedToJson);
+        REGISTER_BEHAVIOUR(AnchorSpec, editingAnchoredValueUpdatesAliases);
+    }
+
+    void aliasesGiveAnchoredValues() {
+        parse_info<> info = context().parse("host: &server \"db.local\"\nport: &port 5432\nbackup: *server\nbackupPort: *port");
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<std::string>("host"), should.equal("db.local"));
+        specify(context().valueAs<std::string>("backup"), should.equal("db.local"));
+        specify(context().valueAs<int>("port"), should.equal(5432));
+        specify(context().valueAs<int>("backupPort"), should.equal(5432));
+    }
+
+    void aliasesShareTheAnchoredValue() {
+        std::string data("cert: &cert |\n  MIIBIjANBgkqhkiG9w0BAQEFAAOCAQ8AMIIBCgKCAQEAu1SU1LfVLPHCozMxH2Mo4lgO");
+        for (int i = 0; i < 100; i++) {
+            data += "\nalias" + std::to_string(i) + ": *cert";
+        }
+        Document plain;
+        plain.collectStats(true);
+        plain.parse(data);
+        Document one;
+        one.collectStats(true);
+        one.parse(data.substr(0, data.find('\n', data.find("alias"))));
+        specify(plain.valueAs<std::string>("alias99"), should.equal(plain.valueAs<std::string>("cert")));
+        specify(plain.stats().bytes - one.stats().bytes < 99 * 100u, should.equal(true));
+    }
+
+    void listItemsCanBeAnchorsAndAliases() {
+        context().parse("- &first one\n- two\n- *first");
+        specify(context().list().count(), should.equal(3u));
+        specify(context().list().valueAs<std::string>(2), should.equal("one"));
+    }
+
+    void unknownAliasThrows() {
+        specify(invoking(parse, std::string("foo: *missing")).should.raise.exception<UnknownAliasException>("Alias 'missing' has no anchor."));
+    }
+
+    void aliasLimitIsEnforced() {
+        context().aliasLimit(2);
+        specify(invoking(parse, std::string("a: &a x\nb: *a\nc: *a\nd: *a")).should.raise.exception<AliasLimitException>("Document has more than 2 aliases."));
+    }
+
+    void editingAnchoredValueUpdatesAliases() {
+        std::string data("a: &v old\nb: *v\n");
+        context().parse(data);
+        context().edit(data, data.find("old"), 3, "new");
+        specify(context().valueAs<std::string>("a"), should.equal("new"));
+        specify(context().valueAs<std::string>("b"), should.equal("new"));
+    }
+
+    void aliasesAreEmittedAsValues() {
+        Document document;
+        document.parse("a: &x value\nb: *x");
+        specify(Emitter().emit(document), should.equal("a: value\nb: value\n"));
+    }
+
+    void aliasesAreTranscodedToJson() {
+        std::stringstream out;
+        JsonTranscoder(out).transcode("a: &x \"v\"\nb: *x\nn: &n 3\nm: *n");
+        specify(out.str(), should.equal("{\"a\":\"v\",\"b\":\"v\",\"n\":3,\"m\":3}"));
+    }
+
+private:
+    typedef parse_info<> (Document::*Parse)(const std::string&);
+    static const Parse parse;
+} anchorSpec;
+
+const AnchorSpec::Parse AnchorSpec::parse = &Document::parse;
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef ASYNCPARSESPEC_H
+#define ASYNCPARSESPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/AsyncParse.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using CppSpec::Specification;
+
+class AsyncParseSpec : public Specification<Document, AsyncParseSpec> {
+public:
+    AsyncParseSpec() {
+        REGISTER_BEHAVIOUR(AsyncParseSpec, inputFedByteByByteIsParsed);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, onlyTheUnfinishedBlockIsKept);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, pushParserReportsErrors);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, pushParserErrorsAreInTheWholeInput);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, pushParserLimitsCoverTheWholeInput);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, parseResumesAsSocketHasBytes);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, manyPipesShareOneLoop);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, resumeParsesOneChunk);
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+        REGISTER_BEHAVIOUR(AsyncParseSpec, coroutineParsesAsSocketHasBytes);
+        REGISTER_BEHAVIOUR(AsyncParseSpec, coroutineResumesOneChunk);
+#endif
+    }
+
+    void inputFedByteByByteIsParsed() {
+        std::string data("name: &n server\ntext: |\n  first\n\n  second\nmap: {a: 1,\n  b: two}\nport: 80\n- one\n- *n\n");
+        PushParser parser(context());
+        for (size_t i = 0; i < data.size(); i++) {
+            parser.feed(&data[i], 1);
+        }
+        specify(parser.finish(), should.equal(true));
+        Document whole;
+        whole.parse(data);
+        specify(context().valueAs<std::string>("text"), should.equal(whole.valueAs<std::string>("text")));
+        specify(context().valueAs<const Mapping&>("map").valueAs<std::string>("b"), should.equal("two"));
+        specify(context().list().count(), should.equal(2u));
+        specify(context().list().valueAs<std::string>(1), should.equal("server"));
+        specify(context().valueAs<int>("port"), should.equal(80));
+    }
+
+    void onlyTheUnfinishedBlockIsKept() {
+        PushParser parser(context());
+        std::string data("a: 1\nb: 2\nc: |\n  text\n");
+        parser.feed(data.data(), data.size());
+        specify(parser.pending(), should.equal(std::string("c: |\n  text\n").size()));
+        specify(context().valueAs<int>("b"), should.equal(2));
+    }
+
+    void pushParserReportsErrors() {
+        PushParser parser(context());
+        std::string data("a: 1\nbroken\nc: 2\n");
+        specify(parser.feed(data.data(), data.size()), should.equal(false));
+        specify(parser.finish(), should.equal(false));
+        specify(parser.error().expected(), should.equal("':' after a key"));
+    }
+
+    void pushParserErrorsAreInTheWholeInput() {
+        PushParser parser(context());
+        std::string data("a: 1\n\nb: 2\n");
+        parser.feed(data.data(), data.size());
+        data = "c: 3\n  broken\n";
+        parser.feed(data.data(), data.size());
+        specify(parser.finish(), should.equal(false));
+        specify(parser.error().offset(), should.equal(18u));
+        specify(parser.error().line(), should.equal(5u));
+        specify(parser.error().column(), should.equal(3u));
+    }
+
+    void pushParserLimitsCoverTheWholeInput() {
+        ParseLimits limits;
+        limits.nodes = 50;
+        context().parseLimits(limits);
+        PushParser parser(context());
+        bool exceeded = false;
+        try {
+            for (int i = 0; i < 100; i++) {
+                std::string line("key" + std::to_string(i) + ": value\n");
+                parser.feed(line.data(), line.size());
+            }
+        } catch (const LimitExceededException& e) {
+            exceeded = e.limit() == LimitExceededException::Nodes;
+        }
+        specify(exceeded, should.equal(true));
+    }
+
+    void parseResumesAsSocketHasBytes() {
+        int fds[2];
+        specify(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), should.equal(0));
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        std::string data(lines(2000));
+        std::thread writer([&data, fds] {
+            for (size_t i = 0; i < data.size(); i += 1000) {
+                size_t size = std::min<size_t>(1000, data.size() - i);
+                checkWritten(::write(fds[1], data.data() + i, size), size);
+                std::this_thread::yield();
+            }
+            ::close(fds[1]);
+        });
+        FdByteSource source(fds[0]);
+        AsyncParse parse(source, context(), 256);
+        while (!parse.resume()) {
+            pollfd readable = {fds[0], POLLIN, 0};
+            poll(&readable, 1, -1);
+        }
+        writer.join();
+        ::close(fds[0]);
+        specify(parse.ok(), should.equal(true));
+        specify(context().valueAs<std::string>("key1999"), should.equal("value"));
+    }
+
+    void manyPipesShareOneLoop() {
+        const size_t count = 64;
+        std::vector<std::unique_ptr<Document> > documents;
+        std::vector<std::unique_ptr<FdByteSource> > sources;
+        std::vector<std::unique_ptr<AsyncParse> > parses;
+        std::vector<pollfd> fds;
+        std::vector<int> writeEnds;
+        for (size_t i = 0; i < count; i++) {
+            int pipeFds[2];
+            specify(pipe(pipeFds), should.equal(0));
+            fcntl(pipeFds[0], F_SETFL, O_NONBLOCK);
+            documents.emplace_back(new Document());
+            sources.emplace_back(new FdByteSource(pipeFds[0]));
+            parses.emplace_back(new AsyncParse(*sources.back(), *documents.back(), 512));
+            pollfd readable = {pipeFds[0], POLLIN, 0};
+            fds.push_back(readable);
+            writeEnds.push_back(pipeFds[1]);
+        }
+        std::string data(lines(300));
+        std::thread writer([&data, &writeEnds] {
+            for (size_t offset = 0; offset < data.size(); offset += 700) {
+                size_t size = std::min<size_t>(700, data.size() - offset);
+                for (size_t i = 0; i < writeEnds.size(); i++) {
+                    checkWritten(::write(writeEnds[i], data.data() + offset, size), size);
+                }
+            }
+            for (size_t i = 0; i < writeEnds.size(); i++) {
+                ::close(writeEnds[i]);
+            }
+        });
+        size_t remaining = count;
+        while (remaining) {
+            poll(&fds[0], fds.size(), -1);
+            for (size_t i = 0; i < count; i++) {
+                if (fds[i].fd >= 0 && fds[i].revents && parses[i]->resume()) {
+                    ::close(fds[i].fd);
+                    fds[i].fd = -1;
+                    remaining--;
+                }
+            }
+        }
+        writer.join();
+        for (size_t i = 0; i < count; i++) {
+            specify(parses[i]->ok(), should.equal(true));
+            specify(documents[i]->valueAs<std::string>("key299"), should.equal("value"));
+        }
+    }
+
+    void resumeParsesOneChunk() {
+        StringSource source(lines(100));
+        AsyncParse parse(source, context(), 64);
+        specify(parse.resume(), should.equal(false));
+        specify(source.reads, should.equal(1u));
+        size_t resumes = 1;
+        while (!parse.resume()) {
+            resumes++;
+        }
+        specify(resumes, should.equal(source.reads - 1));
+        specify(parse.ok(), should.equal(true));
+        specify(context().valueAs<std::string>("key99"), should.equal("value"));
+    }
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+    void coroutineParsesAsSocketHasBytes() {
+        int fds[2];
+        specify(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), should.equal(0));
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        std::string data(lines(2000));
+        std::thread writer([&data, fds] {
+            for (size_t i = 0; i < data.size(); i += 1000) {
+                size_t size = std::min<size_t>(1000, data.size() - i);
+                checkWritten(::write(fds[1], data.data() + i, size), size);
+                std::this_thread::yield();
+            }
+            ::close(fds[1]);
+        });
+        FdByteSource source(fds[0]);
+        AsyncParseTask parse(parseAsync(source, context(), 256));
+        while (!parse.resume()) {
+            pollfd readable = {fds[0], POLLIN, 0};
+            poll(&readable, 1, -1);
+        }
+        writer.join();
+        ::close(fds[0]);
+        specify(parse.ok(), should.equal(true));
+        specify(context().valueAs<std::string>("key1999"), should.equal("value"));
+    }
+
+    void coroutineResumesOneChunk() {
+        StringSource source(lines(100) + "broken\na: 1\n");
+        AsyncParseTask parse(parseAsync(source, context(), 64));
+        specify(source.reads, should.equal(0u));
+        specify(parse.resume(), should.equal(false));
+        specify(source.reads, should.equal(1u));
+        while (!parse.resume()) {
+        }
+        specify(parse.ok(), should.equal(false));
+        specify(context().error().expected(), should.equal("':' after a key"));
+    }
+#endif
+
+private:
+    // Has all of its bytes available at once.
+    struct StringSource : AsyncByteSource {
+        explicit StringSource(const std::string& data) : data(data), offset(0), reads(0) {}
+
+        std::ptrdiff_t read(char* buffer, size_t size) {
+            reads++;
+            size = std::min(size, data.size() - offset);
+            data.copy(buffer, size, offset);
+            offset += size;
+            return size;
+        }
+
+        std::string data;
+        size_t offset;
+        size_t reads;
+    };
+
+    static std::string lines(int count) {
+        std::string data;
+        for (int i = 0; i < count; i++) {
+            data += "key" + std::to_string(i) + ": value\n";
+        }
+        return data;
+    }
+
+    static void checkWritten(ssize_t written, size_t size) {
+        if (written != static_cast<ssize_t>(size)) {
+            std::abort();
+        }
+    }
+} asyncParseSpec;
+
+#endif
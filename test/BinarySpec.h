@@ -0,0 +1,142 @@
+#ifndef BINARYSPEC_H
+#define BINARYSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Binary.h"
+
+using CppSpec::Specification;
+
+class BinarySpec : public Specification<Document, BinarySpec> {
+public:
+    BinarySpec() {
+        REGISTER_BEHAVIOUR(BinarySpec, canEncodeCbor);
+        REGISTER_BEHAVIOUR(BinarySpec, canEncodeMessagePack);
+        REGISTER_BEHAVIOUR(BinarySpec, cborRoundTrips);
+        REGISTER_BEHAVIOUR(BinarySpec, messagePackRoundTrips);
+        REGISTER_BEHAVIOUR(BinarySpec, truncatedInputIsRejected);
+        REGISTER_BEHAVIOUR(BinarySpec, corruptInputLeavesTheDocumentAsItWas);
+        REGISTER_BEHAVIOUR(BinarySpec, decodingReplacesWhatTheDocumentHeld);
+        REGISTER_BEHAVIOUR(BinarySpec, mappingsRoundTripWithTheirMergedEntries);
+        REGISTER_BEHAVIOUR(BinarySpec, deeplyNestedMapsAreRejected);
+    }
+
+    Document* createContext() {
+        Document* doc = new Document();
+        doc->parse("name:Timo\ncount: -1250\nsmall: 5\n- first\n- second");
+        return doc;
+    }
+
+    void canEncodeCbor() {
+        Document doc;
+        doc.parse("count: 5\nn: -1250");
+        specify(Cbor::encode(doc), should.equal(std::string("\xa2\x65" "count\x05\x61n\x39\x04\xe1", 13)));
+    }
+
+    void canEncodeMessagePack() {
+        Document doc;
+        doc.parse("count: 5\nn: -1250");
+        specify(MessagePack::encode(doc), should.equal(std::string("\x82\xa5" "count\x05\xa1n\xd1\xfb\x1e", 13)));
+    }
+
+    void cborRoundTrips() {
+        Document decoded;
+        Cbor::decode(Cbor::encode(context()), decoded);
+        verifyDecoded(decoded);
+    }
+
+    void messagePackRoundTrips() {
+        Document decoded;
+        MessagePack::decode(MessagePack::encode(context()), decoded);
+        verifyDecoded(decoded);
+    }
+
+    void truncatedInputIsRejected() {
+        std::string encoded(Cbor::encode(context()));
+        encoded.resize(encoded.size() - 1);
+        Document decoded;
+        bool thrown = false;
+        try {
+            Cbor::decode(encoded, decoded);
+        } catch (const DecodeException& e) {
+            thrown = std::string(e.what()) == "Cannot decode document: unexpected end of data.";
+        }
+        specify(thrown, should.equal(true));
+    }
+
+    void corruptInputLeavesTheDocumentAsItWas() {
+        std::string cbor(Cbor::encode(context()));
+        cbor.resize(cbor.size() - 1);
+        std::string messagePack(MessagePack::encode(context()));
+        messagePack += '\xc1';
+        Document decoded;
+        decoded.parse("name: kept\n- item\n");
+        try {
+            Cbor::decode(cbor, decoded);
+        } catch (const DecodeException&) {
+        }
+        try {
+            MessagePack::decode(messagePack, decoded);
+        } catch (const DecodeException&) {
+        }
+        specify(decoded.valueAs<std::string>("name"), should.equal("kept"));
+        specify(decoded.list().count(), should.equal(1u));
+        specify(std::distance(decoded.begin(), decoded.end()), should.equal(2));
+    }
+
+    void decodingReplacesWhatTheDocumentHeld() {
+        Document decoded;
+        decoded.parse("base: &base {host: db}\n<<: *base\n");
+        Cbor::decode(Cbor::encode(context()), decoded);
+        specify(decoded.find("host") == 0, should.equal(true));
+        verifyDecoded(decoded);
+        decoded.parse("other: &base {port: 1}\n<<: *base\n");
+        MessagePack::decode(MessagePack::encode(context()), decoded);
+        specify(decoded.find("port") == 0, should.equal(true));
+        verifyDecoded(decoded);
+    }
+
+    void mappingsRoundTripWithTheirMergedEntries() {
+        Document doc;
+        doc.parse("db: {host: local, opts: {ssl: on, retry: 3}}\nbase: &base {port: 5432}\nm: {<<: *base, name: x}\n");
+        specify(Cbor::encode(doc).substr(0, 8), should.equal(std::string("\xa3\x64" "base\xa1\x64" "p", 8)));
+        Document cbor;
+        Cbor::decode(Cbor::encode(doc), cbor);
+        Document messagePack;
+        MessagePack::decode(MessagePack::encode(doc), messagePack);
+        Document* decoded[] = {&cbor, &messagePack};
+        for (size_t i = 0; i < 2; i++) {
+            Mapping db(decoded[i]->valueAs<Mapping>("db"));
+            specify(db.valueAs<std::string>("host"), should.equal("local"));
+            specify(db.valueAs<Mapping>("opts").valueAs<int>("retry"), should.equal(3));
+            specify(decoded[i]->valueAs<Mapping>("m").valueAs<int>("port"), should.equal(5432));
+            specify(decoded[i]->valueAs<Mapping>("m").valueAs<std::string>("name"), should.equal("x"));
+        }
+    }
+
+    void deeplyNestedMapsAreRejected() {
+        std::string encoded("\xa1\x61k");
+        for (int i = 0; i < 600; i++) {
+            encoded += "\xa1\x61k";
+        }
+        encoded += '\x01';
+        Document decoded;
+        std::string error;
+        try {
+            Cbor::decode(encoded, decoded);
+        } catch (const DecodeException& e) {
+            error = e.what();
+        }
+        specify(error, should.equal("Cannot decode document: items nested too deeply."));
+    }
+
+private:
+    void verifyDecoded(Document& decoded) {
+        specify(decoded.valueAs<std::string>("name"), should.equal("Timo"));
+        specify(decoded.valueAs<int>("count"), should.equal(-1250));
+        specify(decoded.valueAs<int>("small"), should.equal(5));
+        specify(decoded.list().count(), should.equal(2u));
+        specify(decoded.list().valueAs<std::string>(1), should.equal("second"));
+    }
+} binarySpec;
+
+#endif
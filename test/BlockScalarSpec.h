@@ -0,0 +1,61 @@
+#ifndef BLOCKSCALARSPEC_H
+#define BLOCKSCALARSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+#include "yamlpp/JsonTranscoder.h"
+
+using CppSpec::Specification;
+
+class BlockScalarSpec : public Specification<Document, BlockScalarSpec> {
+public:
+    BlockScalarSpec() {
+        REGISTER_BEHAVIOUR(BlockScalarSpec, literalBlocksKeepLineBreaks);
+        REGISTER_BEHAVIOUR(BlockScalarSpec, foldedBlocksJoinLines);
+        REGISTER_BEHAVIOUR(BlockScalarSpec, chompingIndicatorsAreHonoured);
+        REGISTER_BEHAVIOUR(BlockScalarSpec, blockEndsAtLessIndentedLine);
+        REGISTER_BEHAVIOUR(BlockScalarSpec, listItemsCanBeBlocks);
+        REGISTER_BEHAVIOUR(BlockScalarSpec, blocksAreTranscodedToJson);
+    }
+
+    void literalBlocksKeepLineBreaks() {
+        parse_info<> info = context().parse("script: |\n  echo one\n    indented\n\n  echo two");
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<std::string>("script"), should.equal("echo one\n  indented\n\necho two\n"));
+    }
+
+    void foldedBlocksJoinLines() {
+        context().parse("text: >\n  one\n  two\n\n  three\n    kept\n  four");
+        specify(context().valueAs<std::string>("text"), should.equal("one two\nthree\n  kept\nfour\n"));
+    }
+
+    void chompingIndicatorsAreHonoured() {
+        context().parse("strip: |-\n  text\n\nkeep: |+\n  text\n\nclip: |2\n  text\n\nlast: x");
+        specify(context().valueAs<std::string>("strip"), should.equal("text"));
+        specify(context().valueAs<std::string>("keep"), should.equal("text\n\n"));
+        specify(context().valueAs<std::string>("clip"), should.equal("text\n"));
+        specify(context().valueAs<std::string>("last"), should.equal("x"));
+    }
+
+    void blockEndsAtLessIndentedLine() {
+        parse_info<> info = context().parse("cert: |\n  ---BEGIN---\n  MIIB\n  ---END---\nname: server");
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<std::string>("cert"), should.equal("---BEGIN---\nMIIB\n---END---\n"));
+        specify(context().valueAs<std::string>("name"), should.equal("server"));
+    }
+
+    void listItemsCanBeBlocks() {
+        parse_info<> info = context().parse("- >-\n  folded\n  item\n- plain");
+        specify(info.full, should.equal(true));
+        specify(context().list().valueAs<std::string>(0), should.equal("folded item"));
+        specify(context().list().valueAs<std::string>(1), should.equal("plain"));
+    }
+
+    void blocksAreTranscodedToJson() {
+        std::stringstream out;
+        JsonTranscoder(out).transcode("script: |\n  a\n  b");
+        specify(out.str(), should.equal("{\"script\":\"a\\nb\\n\"}"));
+    }
+} blockScalarSpec;
+
+#endif
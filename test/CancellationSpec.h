@@ -0,0 +1,102 @@
+#ifndef CANCELLATIONSPEC_H
+#define CANCELLATIONSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+#include <thread>
+#include <vector>
+
+using CppSpec::Specification;
+
+class CancellationSpec : public Specification<Document, CancellationSpec> {
+public:
+    CancellationSpec() {
+        REGISTER_BEHAVIOUR(CancellationSpec, uncancelledParseCompletes);
+        REGISTER_BEHAVIOUR(CancellationSpec, cancelledTokenStopsParse);
+        REGISTER_BEHAVIOUR(CancellationSpec, progressIsReportedEveryInterval);
+        REGISTER_BEHAVIOUR(CancellationSpec, parseCanBeCancelledWhileRunning);
+        REGISTER_BEHAVIOUR(CancellationSpec, parseCanBeCancelledFromAnotherThread);
+    }
+
+    void uncancelledParseCompletes() {
+        CancellationToken token;
+        parse_info<> info = context().parse("a: 1\nb: 2", token);
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<int>("b"), should.equal(2));
+    }
+
+    void cancelledTokenStopsParse() {
+        CancellationToken token;
+        token.cancel();
+        try {
+            context().parse("a: 1", token);
+            specify(false, should.equal(true));
+        } catch (const ParseCancelledException& e) {
+            specify(std::string(e.what()), should.equal("Parse was cancelled."));
+        }
+        specify(context().begin() == context().end(), should.equal(true));
+    }
+
+    void progressIsReportedEveryInterval() {
+        std::string data(lines(1000));
+        CancellationToken token;
+        std::vector<size_t> reported;
+        context().parse(data, token, [&reported](size_t bytes) {reported.push_back(bytes);}, 1000);
+        specify(reported.size() > data.size() / 1000, should.equal(true));
+        specify(reported.size() <= data.size() / 1000 + 2, should.equal(true));
+        specify(reported.front(), should.equal(0u));
+        specify(reported.back(), should.equal(data.size()));
+        for (size_t i = 1; i + 1 < reported.size(); i++) {
+            specify(reported[i] - reported[i - 1] >= 1000u, should.equal(true));
+        }
+    }
+
+    void parseCanBeCancelledWhileRunning() {
+        std::string data(lines(1000));
+        CancellationToken token;
+        size_t last = 0;
+        try {
+            context().parse(data, token, [&token, &last](size_t bytes) {
+                last = bytes;
+                if (bytes > 5000) {
+                    token.cancel();
+                }
+            }, 1000);
+            specify(false, should.equal(true));
+        } catch (const ParseCancelledException&) {
+        }
+        specify(last > 5000u && last < 7000u, should.equal(true));
+        specify(context().begin() == context().end(), should.equal(true));
+    }
+
+    void parseCanBeCancelledFromAnotherThread() {
+        std::string data(lines(200000));
+        CancellationToken token;
+        std::atomic<bool> started(false);
+        std::thread canceller([&token, &started] {
+            while (!started) {
+                std::this_thread::yield();
+            }
+            token.cancel();
+        });
+        bool cancelled = false;
+        try {
+            context().parse(data, token, [&started](size_t) {started = true;}, 1024);
+        } catch (const ParseCancelledException&) {
+            cancelled = true;
+        }
+        canceller.join();
+        specify(cancelled, should.equal(true));
+    }
+
+private:
+    static std::string lines(int count) {
+        std::string data;
+        for (int i = 0; i < count; i++) {
+            data += "key" + std::to_string(i) + ": value\n";
+        }
+        return data;
+    }
+} cancellationSpec;
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef COMMENTSPEC_H
+#define COMMENTSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+#include "yamlpp/Emitter.h"
+#include "yamlpp/JsonTranscoder.h"
+
+using CppSpec::Specification;
+
+class CommentSpec : public Specification<Document, CommentSpec> {
+public:
+    CommentSpec() {
+        REGISTER_BEHAVIOUR(CommentSpec, commentsAreSkipped);
+        REGISTER_BEHAVIOUR(CommentSpec, commentsAreNotKeptByDefault);
+        REGISTER_BEHAVIOUR(CommentSpec, keptCommentsAttachToNextKey);
+        REGISTER_BEHAVIOUR(CommentSpec, keptCommentsAreEmitted);
+        REGISTER_BEHAVIOUR(CommentSpec, hashInsideQuotesIsNotAComment);
+        REGISTER_BEHAVIOUR(CommentSpec, transcoderSkipsComments);
+    }
+
+    void commentsAreSkipped() {
+        parse_info<> info = context().parse("# header\nfoo: bar # trailing\n\t\r\n  # indented\nnum: 3\n# last");
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<std::string>("foo"), should.equal("bar"));
+        specify(context().valueAs<int>("num"), should.equal(3));
+    }
+
+    void commentsAreNotKeptByDefault() {
+        context().parse("# header\nfoo: bar");
+        specify(context().comment("foo"), should.equal(""));
+    }
+
+    void keptCommentsAttachToNextKey() {
+        Document document;
+        document.keepComments(true);
+        document.parse("# first\n# second\nfoo: bar # about num\nnum: 3\n- item");
+        specify(document.comment("foo"), should.equal(" first\n second"));
+        specify(document.comment("num"), should.equal(" about num"));
+        specify(document.list().count(), should.equal(1u));
+    }
+
+    void keptCommentsAreEmitted() {
+        Document document;
+        document.keepComments(true);
+        document.parse("#owner: ops\nfoo: bar");
+        specify(Emitter().emit(document), should.equal("#owner: ops\nfoo: bar\n"));
+    }
+
+    void hashInsideQuotesIsNotAComment() {
+        context().parse("foo: \"a # b\"");
+        specify(context().valueAs<std::string>("foo"), should.equal("a # b"));
+    }
+
+    void transcoderSkipsComments() {
+        std::stringstream out;
+        JsonTranscoder(out).transcode("# header\nfoo: bar # trailing\nnum: 1");
+        specify(out.str(), should.equal("{\"foo\":\"bar\",\"num\":1}"));
+    }
+} commentSpec;
+
+#endif
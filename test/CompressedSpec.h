@@ -0,0 +1,124 @@
+#ifndef COMPRESSEDSPEC_H
+#define COMPRESSEDSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Compressed.h"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using CppSpec::Specification;
+
+class CompressedSpec : public Specification<Document, CompressedSpec> {
+public:
+    CompressedSpec() {
+        REGISTER_BEHAVIOUR(CompressedSpec, gzipInputIsParsedInSmallChunks);
+        REGISTER_BEHAVIOUR(CompressedSpec, zlibInputIsParsed);
+        REGISTER_BEHAVIOUR(CompressedSpec, concatenatedMembersAreOneInput);
+        REGISTER_BEHAVIOUR(CompressedSpec, compressedFileIsParsed);
+        REGISTER_BEHAVIOUR(CompressedSpec, parseErrorStopsInflating);
+        REGISTER_BEHAVIOUR(CompressedSpec, corruptInputIsReported);
+        REGISTER_BEHAVIOUR(CompressedSpec, truncatedInputIsReported);
+    }
+
+    void gzipInputIsParsedInSmallChunks() {
+        std::string data(document(500));
+        std::string compressed(deflated(data, 15 + 16));
+        GzipSource source(compressed.data(), compressed.size());
+        specify(CompressedParser(context(), 7, 2).parse(source), should.equal(true));
+        specify(context().valueAs<std::string>("text"), should.equal("first\n\nsecond\n"));
+        specify(context().valueAs<int>("key499"), should.equal(499));
+        specify(context().list().count(), should.equal(500u));
+        specify(context().list().valueAs<std::string>(499), should.equal("item"));
+    }
+
+    void zlibInputIsParsed() {
+        std::string compressed(deflated("name: server\nport: 80\n", 15));
+        GzipSource source(compressed.data(), compressed.size());
+        specify(CompressedParser(context()).parse(source), should.equal(true));
+        specify(context().valueAs<int>("port"), should.equal(80));
+    }
+
+    void concatenatedMembersAreOneInput() {
+        std::string compressed(deflated("a: 1\n", 15 + 16) + deflated("b: 2\n", 15 + 16));
+        GzipSource source(compressed.data(), compressed.size());
+        specify(CompressedParser(context()).parse(source), should.equal(true));
+        specify(context().valueAs<int>("a"), should.equal(1));
+        specify(context().valueAs<int>("b"), should.equal(2));
+    }
+
+    void compressedFileIsParsed() {
+        char path[] = "/tmp/yamlppXXXXXX";
+        int fd = mkstemp(path);
+        std::string compressed(deflated(document(2000), 15 + 16));
+        specify(::write(fd, compressed.data(), compressed.size()), should.equal(static_cast<ssize_t>(compressed.size())));
+        ::lseek(fd, 0, SEEK_SET);
+        GzipSource source(fd, 100);
+        specify(CompressedParser(context(), 1024).parse(source), should.equal(true));
+        specify(context().valueAs<int>("key1999"), should.equal(1999));
+        ::close(fd);
+        std::remove(path);
+    }
+
+    void parseErrorStopsInflating() {
+        std::string compressed(deflated("a: 1\nbroken\n" + document(5000), 15 + 16));
+        GzipSource source(compressed.data(), compressed.size());
+        CompressedParser parser(context(), 16, 2);
+        specify(parser.parse(source), should.equal(false));
+        specify(parser.error().expected(), should.equal("':' after a key"));
+        specify(context().valueAs<int>("a"), should.equal(1));
+    }
+
+    void corruptInputIsReported() {
+        std::string compressed(deflated(document(100), 15 + 16));
+        compressed[compressed.size() / 2] ^= 0x55;
+        compressed[compressed.size() / 2 + 1] ^= 0x55;
+        GzipSource source(compressed.data(), compressed.size());
+        specify(failure(source).substr(0, 27), should.equal("Compressed input is corrupt"));
+    }
+
+    void truncatedInputIsReported() {
+        std::string compressed(deflated(document(100), 15 + 16));
+        compressed.resize(compressed.size() / 2);
+        GzipSource source(compressed.data(), compressed.size());
+        specify(failure(source), should.equal("Compressed input is truncated"));
+    }
+
+private:
+    std::string failure(GzipSource& source) {
+        try {
+            CompressedParser(context()).parse(source);
+        } catch (const std::runtime_error& error) {
+            return error.what();
+        }
+        return std::string();
+    }
+
+    static std::string document(int keys) {
+        std::string data("text: |\n  first\n\n  second\n");
+        for (int i = 0; i < keys; i++) {
+            data += "key" + std::to_string(i) + ": " + std::to_string(i) + "\n";
+        }
+        for (int i = 0; i < keys; i++) {
+            data += "- item\n";
+        }
+        return data;
+    }
+
+    // Compresses data with a gzip header when windowBits has 16 added.
+    static std::string deflated(const std::string& data, int windowBits) {
+        z_stream stream = z_stream();
+        deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+        std::string compressed(deflateBound(&stream, data.size()), '\0');
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = data.size();
+        stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+        stream.avail_out = compressed.size();
+        deflate(&stream, Z_FINISH);
+        compressed.resize(stream.total_out);
+        deflateEnd(&stream);
+        return compressed;
+    }
+} compressedSpec;
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef DIFFSPEC_H
+#define DIFFSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Diff.h"
+#include "yamlpp/Patch.h"
+
+using CppSpec::Specification;
+
+class DiffSpec : public Specification<Document, DiffSpec> {
+public:
+    DiffSpec() {
+        REGISTER_BEHAVIOUR(DiffSpec, equalDocumentsHaveNoChanges);
+        REGISTER_BEHAVIOUR(DiffSpec, keysAreAddedRemovedAndChanged);
+        REGISTER_BEHAVIOUR(DiffSpec, changesInsideMappingsHaveTheirPath);
+        REGISTER_BEHAVIOUR(DiffSpec, listItemsAreComparedByIndex);
+        REGISTER_BEHAVIOUR(DiffSpec, aliasesCompareByWhatTheyStandFor);
+        REGISTER_BEHAVIOUR(DiffSpec, mergedKeysAreCompared);
+        REGISTER_BEHAVIOUR(DiffSpec, hashesIgnoreEntryOrder);
+        REGISTER_BEHAVIOUR(DiffSpec, hashesTellTypesApart);
+        REGISTER_BEHAVIOUR(DiffSpec, changingAListClearsItsHash);
+        REGISTER_BEHAVIOUR(DiffSpec, documentHashFollowsChanges);
+        REGISTER_BEHAVIOUR(DiffSpec, keysAreEscapedInPaths);
+    }
+
+    void equalDocumentsHaveNoChanges() {
+        context().parse("name: server\nport: 80\nopts: {ssl: on, retry: {count: 3}}\n- one\n- two\n");
+        Document copy(context());
+        specify(Diff::compare(context(), copy).size(), should.equal(0u));
+    }
+
+    void keysAreAddedRemovedAndChanged() {
+        context().parse("name: server\nport: 80\nold: gone\n");
+        specify(describe(Diff::compare(context(), parsed("name: server\nport: 8080\nnew: here\n"))), should.equal("+/new -/old ~/port"));
+    }
+
+    void changesInsideMappingsHaveTheirPath() {
+        context().parse("db: {host: local, opts: {ssl: on, retry: 3}}\nname: x\n");
+        Document after(parsed("db: {host: local, opts: {ssl: off, retry: 3, timeout: 5}}\nname: x\n"));
+        specify(describe(Diff::compare(context(), after)), should.equal("~/db/opts/ssl +/db/opts/timeout"));
+    }
+
+    void listItemsAreComparedByIndex() {
+        context().parse("- one\n- two\n- three\n");
+        specify(describe(Diff::compare(context(), parsed("- one\n- six\n- three\n- four\n"))), should.equal("~/-/1 +/-/3"));
+        specify(describe(Diff::compare(context(), parsed("- one\n"))), should.equal("-/-/1 -/-/2"));
+        specify(describe(Diff::compare(context(), parsed("name: x\n"))), should.equal("+/name -/-"));
+    }
+
+    void aliasesCompareByWhatTheyStandFor() {
+        context().parse("a: &a {x: 1}\nb: *a\n");
+        specify(Diff::compare(context(), parsed("a: {x: 1}\nb: {x: 1}\n")).size(), should.equal(0u));
+        specify(describe(Diff::compare(context(), parsed("a: {x: 1}\nb: {x: 2}\n"))), should.equal("~/b/x"));
+    }
+
+    void mergedKeysAreCompared() {
+        context().parse("base: &base {host: db, port: 5432}\n<<: *base\nport: 6000\n");
+        specify(Diff::compare(context(), parsed("base: {host: db, port: 5432}\nhost: db\nport: 6000\n")).size(), should.equal(0u));
+        specify(describe(Diff::compare(context(), parsed("base: {host: db, port: 5432}\nport: 6000\n"))), should.equal("-/host"));
+        specify(describe(Diff::compare(parsed("m: {<<: {a: 1}, b: 2}\n"), parsed("m: {a: 3, b: 2}\n"))), should.equal("~/m/a"));
+    }
+
+    void hashesIgnoreEntryOrder() {
+        context().parse("m: {a: 1, b: two, c: {d: 4}}\n");
+        Document other(parsed("m: {c: {d: 4}, b: two, a: 1}\n"));
+        specify(structuralHash(*context().find("m")), should.equal(structuralHash(*other.find("m"))));
+        specify(structuralHash(*context().find("m")) == structuralHash(*parsed("m: {a: 1, b: two, c: {d: 5}}\n").find("m")), should.equal(false));
+    }
+
+    void hashesTellTypesApart() {
+        specify(structuralHash(boost::any(1)) == structuralHash(boost::any(std::string("1"))), should.equal(false));
+        specify(structuralHash(boost::any(Mapping())) == structuralHash(boost::any(List())), should.equal(false));
+        specify(structuralHash(boost::any()) == structuralHash(boost::any(std::string())), should.equal(false));
+    }
+
+    void changingAListClearsItsHash() {
+        context().parse("- one\n- two\n");
+        boost::uint64_t before = context().list().hash();
+        context().list().add(std::string("three"));
+        specify(context().list().hash() == before, should.equal(false));
+        context().list().valueAs<std::string>(2) = "two";
+        boost::uint64_t changed = context().list().hash();
+        context().list().valueAs<std::string>(2) = "three";
+        specify(context().list().hash() == changed, should.equal(false));
+    }
+
+    void documentHashFollowsChanges() {
+        std::string data("name: server\nport: 80\n- one\n");
+        context().parse(data);
+        Document other(parsed(data));
+        specify(context().hash(), should.equal(other.hash()));
+        Patch().replace("/port", boost::any(8080)).apply(other);
+        specify(describe(Diff::compare(context(), other)), should.equal("~/port"));
+        context().edit(data, 0, 13, "");
+        specify(describe(Diff::compare(context(), parsed("port: 80\n- one\n"))), should.equal(""));
+        context().list().add(std::string("two"));
+        specify(describe(Diff::compare(context(), parsed("port: 80\n- one\n"))), should.equal("-/-/1"));
+    }
+
+    void keysAreEscapedInPaths() {
+        context().parse("\"a/b\": 1\n\"c~d\": 2\n");
+        specify(describe(Diff::compare(context(), parsed("\"a/b\": 2\n\"c~d\": 3\n"))), should.equal("~/a~1b ~/c~0d"));
+    }
+
+private:
+    static Document parsed(const std::string& data) {
+        Document document;
+        document.parse(data);
+        return document;
+    }
+
+    static std::string describe(const std::vector<Change>& changes) {
+        static const char kinds[] = "+-~";
+        std::string out;
+        for (size_t i = 0; i < changes.size(); i++) {
+            out += (i ? " " : "") + std::string(1, kinds[changes[i].kind]) + changes[i].path;
+        }
+        return out;
+    }
+} diffSpec;
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef DOCUMENTPOOLSPEC_H
+#define DOCUMENTPOOLSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/DocumentPool.h"
+
+using CppSpec::Specification;
+
+class DocumentPoolSpec : public Specification<DocumentPool, DocumentPoolSpec> {
+public:
+    DocumentPoolSpec() {
+        REGISTER_BEHAVIOUR(DocumentPoolSpec, resetEmptiesTheDocument);
+        REGISTER_BEHAVIOUR(DocumentPoolSpec, reparsingAfterResetDoesNotAllocate);
+        REGISTER_BEHAVIOUR(DocumentPoolSpec, releasedDocumentsAreReused);
+    }
+
+    void resetEmptiesTheDocument() {
+        Document document;
+        document.parse("foo:bar\n- first");
+        document.reset();
+        specify(document.begin() == document.end(), should.equal(true));
+        Document::parseInto("baz:zyx", document);
+        specify(document.valueAs<std::string>("baz"), should.equal("zyx"));
+        specify(std::distance(document.begin(), document.end()), should.equal(1));
+    }
+
+    void reparsingAfterResetDoesNotAllocate() {
+        std::string data("name:averylongvaluethatisnotinlined\ncount: 5\n- averylongitemthatisnotinlined\n- another");
+        Document document;
+        document.parse(data);
+        document.collectStats(true);
+        Document::parseInto(data, document);
+
+        specify(document.stats().allocations, should.equal(0u));
+        specify(document.valueAs<std::string>("name"), should.equal("averylongvaluethatisnotinlined"));
+        specify(document.valueAs<int>("count"), should.equal(5));
+        specify(document.list().count(), should.equal(2u));
+        specify(document.list().valueAs<std::string>(1), should.equal("another"));
+    }
+
+    void releasedDocumentsAreReused() {
+        Document* first;
+        {
+            PooledDocument document(context());
+            document->parse("foo:bar");
+            first = &*document;
+        }
+        specify(context().size(), should.equal(1u));
+        PooledDocument document(context());
+        specify(&*document == first, should.equal(true));
+        specify(document->begin() == document->end(), should.equal(true));
+    }
+} documentPoolSpec;
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef EMITTERSPEC_H
+#define EMITTERSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Emitter.h"
+
+using CppSpec::Specification;
+
+class EmitterSpec : public Specification<Document, EmitterSpec> {
+public:
+    EmitterSpec() {
+        REGISTER_BEHAVIOUR(EmitterSpec, canEmitMappingsInBlockStyle);
+        REGISTER_BEHAVIOUR(EmitterSpec, canEmitMappingsInFlowStyle);
+        REGISTER_BEHAVIOUR(EmitterSpec, flowStyleParsesBack);
+        REGISTER_BEHAVIOUR(EmitterSpec, emittedListParsesBack);
+        REGISTER_BEHAVIOUR(EmitterSpec, stringsThatWouldNotParseBackAreQuoted);
+        REGISTER_BEHAVIOUR(EmitterSpec, emittedStringsParseBackAsThemselves);
+    }
+
+    Document* createContext() {
+        Document* doc = new Document();
+        doc->parse("foo:bar\nbaz:zyx\ncount: -1250");
+        return doc;
+    }
+
+    void canEmitMappingsInBlockStyle() {
+        specify(Emitter().emit(context()), should.equal("baz: zyx\ncount: -1250\nfoo: bar\n"));
+    }
+
+    void canEmitMappingsInFlowStyle() {
+        Document nested;
+        nested.keepComments(true);
+        nested.parse("#server\nname: web\nmap: {a: 1, b: two}\n- first\n- second");
+        specify(Emitter(Emitter::Flow).emit(nested), should.equal("map: {a: 1, b: two}\nname: web\n- first\n- second\n"));
+    }
+
+    void flowStyleParsesBack() {
+        Document nested;
+        nested.parse("name: web\nmap: {a: 1, b: two}\nport: 80\n- first\n- second");
+        Document parsed;
+        parsed.parse(Emitter(Emitter::Flow).emit(nested));
+
+        specify(parsed.valueAs<std::string>("name"), should.equal("web"));
+        specify(parsed.valueAs<int>("port"), should.equal(80));
+        specify(parsed.valueAs<const Mapping&>("map").valueAs<std::string>("b"), should.equal("two"));
+        specify(parsed.list().count(), should.equal(2u));
+        specify(parsed.list().valueAs<std::string>(1), should.equal("second"));
+    }
+
+    void emittedListParsesBack() {
+        Document list;
+        list.parse("- first\n- second\n- third");
+        Document parsed;
+        parsed.parse(Emitter().emit(list));
+
+        specify(parsed.list().count(), should.equal(3u));
+        specify(parsed.list().valueAs<std::string>(2), should.equal("third"));
+    }
+
+    void stringsThatWouldNotParseBackAreQuoted() {
+        specify(Emitter::needsQuotes("plain"), should.equal(false));
+        specify(Emitter::needsQuotes("5"), should.equal(true));
+        specify(Emitter::needsQuotes("a: b"), should.equal(true));
+        std::string out;
+        Emitter::writeString("say \"hi\"\n", out);
+        specify(out, should.equal("\"say \\\"hi\\\"\\n\""));
+    }
+
+    void emittedStringsParseBackAsThemselves() {
+        const char* values[] = {"hello world", "abc1", "a_b", "x/y", "foo.bar", "caf\xc3\xa9", "- x", "", "plain"};
+        const size_t count = sizeof(values) / sizeof(values[0]);
+        std::string data;
+        std::string nested("nested: {");
+        for (size_t i = 0; i < count; i++) {
+            data += "key" + std::to_string(i) + ": ";
+            Emitter::writeString(values[i], data);
+            data += "\n";
+            nested += (i ? ", " : "") + std::string("key") + std::to_string(i) + ": ";
+            Emitter::writeString(values[i], nested);
+        }
+        Document document;
+        document.parse(data + nested + "}\n");
+        Document parsed;
+        specify(parsed.parse(Emitter().emit(document)).full, should.equal(true));
+        for (size_t i = 0; i < count; i++) {
+            std::string key("key" + std::to_string(i));
+            specify(parsed.valueAs<std::string>(key), should.equal(values[i]));
+            specify(parsed.valueAs<Mapping>("nested").valueAs<std::string>(key), should.equal(values[i]));
+        }
+        specify(Emitter::needsQuotes("key1", true), should.equal(false));
+        specify(Emitter::needsQuotes("a_b", true), should.equal(true));
+    }
+} emitterSpec;
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef EXECUTORSPEC_H
+#define EXECUTORSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Executor.h"
+#include <set>
+#include <stdexcept>
+
+using CppSpec::Specification;
+
+class ExecutorSpec : public Specification<WorkStealingPool, ExecutorSpec> {
+public:
+    ExecutorSpec() {
+        REGISTER_BEHAVIOUR(ExecutorSpec, everyTaskIsRun);
+        REGISTER_BEHAVIOUR(ExecutorSpec, tasksRunOnSeveralThreads);
+        REGISTER_BEHAVIOUR(ExecutorSpec, idleThreadsStealWork);
+        REGISTER_BEHAVIOUR(ExecutorSpec, firstErrorIsRaisedAfterTheRest);
+        REGISTER_BEHAVIOUR(ExecutorSpec, poolCanBeReused);
+        REGISTER_BEHAVIOUR(ExecutorSpec, pinnedPoolRunsTasks);
+        REGISTER_BEHAVIOUR(ExecutorSpec, defaultExecutorCanBeReplaced);
+    }
+
+    WorkStealingPool* createContext() {
+        return new WorkStealingPool(4);
+    }
+
+    void everyTaskIsRun() {
+        std::vector<std::atomic<int> > runs(1000);
+        std::vector<SizedTask> tasks;
+        for (size_t i = 0; i < runs.size(); i++) {
+            runs[i] = 0;
+            tasks.push_back(SizedTask([&runs, i] {runs[i]++;}, i % 17));
+        }
+        context().run(tasks);
+        for (size_t i = 0; i < runs.size(); i++) {
+            specify(runs[i].load(), should.equal(1));
+        }
+    }
+
+    void tasksRunOnSeveralThreads() {
+        std::mutex lock;
+        std::set<std::thread::id> threads;
+        std::atomic<int> waiting(0);
+        std::vector<SizedTask> tasks;
+        for (int i = 0; i < 4; i++) {
+            tasks.push_back(SizedTask([&] {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    threads.insert(std::this_thread::get_id());
+                }
+                waiting++;
+                while (waiting < 2) {
+                    std::this_thread::yield();
+                }
+            }, 100));
+        }
+        context().run(tasks);
+        specify(threads.size() >= 2u, should.equal(true));
+    }
+
+    void idleThreadsStealWork() {
+        WorkStealingPool pool(2);
+        std::atomic<int> done(0);
+        std::vector<SizedTask> tasks;
+        tasks.push_back(SizedTask([&done] {
+            while (done < 99) {
+                std::this_thread::yield();
+            }
+        }, 1));
+        for (int i = 0; i < 99; i++) {
+            tasks.push_back(SizedTask([&done] {done++;}, 1));
+        }
+        pool.run(tasks);
+        specify(done.load(), should.equal(99));
+    }
+
+    void firstErrorIsRaisedAfterTheRest() {
+        std::atomic<int> done(0);
+        std::vector<SizedTask> tasks;
+        for (int i = 0; i < 50; i++) {
+            tasks.push_back(SizedTask([&done, i] {
+                done++;
+                if (i == 10) {
+                    throw std::runtime_error("task failed");
+                }
+            }, 1));
+        }
+        specify(invoking(&WorkStealingPool::run, tasks).should.raise.exception<std::runtime_error>("task failed"));
+        specify(done.load(), should.equal(50));
+    }
+
+    void poolCanBeReused() {
+        std::atomic<int> done(0);
+        std::vector<SizedTask> tasks(10, SizedTask([&done] {done++;}, 1));
+        for (int i = 0; i < 100; i++) {
+            context().run(tasks);
+        }
+        specify(done.load(), should.equal(1000));
+    }
+
+    void pinnedPoolRunsTasks() {
+        WorkStealingPool pinned(2, true);
+        std::atomic<int> done(0);
+        pinned.run(std::vector<SizedTask>(20, SizedTask([&done] {done++;}, 1)));
+        specify(done.load(), should.equal(20));
+        specify(pinned.size(), should.equal(2u));
+    }
+
+    void defaultExecutorCanBeReplaced() {
+        InlineExecutor inline_executor;
+        setDefaultExecutor(&inline_executor);
+        specify(&defaultExecutor() == &inline_executor, should.equal(true));
+        setDefaultExecutor(0);
+        specify(&defaultExecutor() == &inline_executor, should.equal(false));
+    }
+} executorSpec;
+
+#endif
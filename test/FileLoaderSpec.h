@@ -0,0 +1,104 @@
+#ifndef FILELOADERSPEC_H
+#define FILELOADERSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/FileLoader.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+
+using CppSpec::Specification;
+
+class FileLoaderSpec : public Specification<FileLoader, FileLoaderSpec> {
+public:
+    FileLoaderSpec() {
+        REGISTER_BEHAVIOUR(FileLoaderSpec, filesAreLoadedInOrder);
+        REGISTER_BEHAVIOUR(FileLoaderSpec, filesAreHandedOverAsTheyFinish);
+        REGISTER_BEHAVIOUR(FileLoaderSpec, unreadableFileIsReported);
+        REGISTER_BEHAVIOUR(FileLoaderSpec, unparsableFileIsReported);
+        REGISTER_BEHAVIOUR(FileLoaderSpec, singleThreadLoadsToo);
+    }
+
+    void filesAreLoadedInOrder() {
+        std::vector<std::string> paths(writeFiles(200));
+        std::vector<LoadedDocument> loaded(context().loadAll(paths));
+        specify(loaded.size(), should.equal(200u));
+        for (size_t i = 0; i < loaded.size(); i++) {
+            specify(loaded[i].ok(), should.equal(true));
+            specify(loaded[i].path, should.equal(paths[i]));
+            specify(loaded[i].document.valueAs<int>("index"), should.equal(static_cast<int>(i)));
+        }
+        removeFiles(paths);
+    }
+
+    void filesAreHandedOverAsTheyFinish() {
+        std::vector<std::string> paths(writeFiles(100));
+        std::set<int> seen;
+        std::vector<Document> kept;
+        context().loadAll(paths, [&seen, &kept](LoadedDocument& loaded) {
+            seen.insert(loaded.document.valueAs<int>("index"));
+            kept.push_back(std::move(loaded.document));
+        });
+        specify(seen.size(), should.equal(100u));
+        specify(kept.size(), should.equal(100u));
+        specify(kept.back().valueAs<std::string>("name").substr(0, 4), should.equal("file"));
+        removeFiles(paths);
+    }
+
+    void unreadableFileIsReported() {
+        std::vector<std::string> paths(1, directory() + "/missing.yaml");
+        std::vector<LoadedDocument> loaded(context().loadAll(paths));
+        specify(loaded[0].ok(), should.equal(false));
+        specify(loaded[0].error, should.equal("Cannot read " + paths[0] + ": No such file or directory"));
+    }
+
+    void unparsableFileIsReported() {
+        std::vector<std::string> paths(1, directory() + "/broken.yaml");
+        std::ofstream(paths[0].c_str()) << "key: value\nbroken\n";
+        std::vector<LoadedDocument> loaded(context().loadAll(paths));
+        specify(loaded[0].ok(), should.equal(false));
+        specify(loaded[0].error, should.equal("Expected ':' after a key at line 2, column 1: broken"));
+        specify(loaded[0].document.valueAs<std::string>("key"), should.equal("value"));
+        removeFiles(paths);
+    }
+
+    void singleThreadLoadsToo() {
+        std::vector<std::string> paths(writeFiles(10));
+        WorkStealingPool pool(1);
+        std::vector<LoadedDocument> loaded(FileLoader(pool).loadAll(paths));
+        specify(loaded[9].document.valueAs<int>("index"), should.equal(9));
+        removeFiles(paths);
+    }
+
+private:
+    static const std::string& directory() {
+        static std::string path;
+        if (path.empty()) {
+            char name[] = "/tmp/yamlppXXXXXX";
+            path = mkdtemp(name);
+        }
+        return path;
+    }
+
+    static std::vector<std::string> writeFiles(int count) {
+        std::vector<std::string> paths;
+        for (int i = 0; i < count; i++) {
+            paths.push_back(directory() + "/file" + std::to_string(i) + ".yaml");
+            std::ofstream file(paths.back().c_str());
+            file << "name: \"file" << i << "\"\nindex: " << i << "\n";
+            for (int j = 0; j < i % 7 * 50; j++) {
+                file << "- item" << j << "\n";
+            }
+        }
+        return paths;
+    }
+
+    static void removeFiles(const std::vector<std::string>& paths) {
+        for (size_t i = 0; i < paths.size(); i++) {
+            std::remove(paths[i].c_str());
+        }
+    }
+} fileLoaderSpec;
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef JSONTRANSCODERSPEC_H
+#define JSONTRANSCODERSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/JsonTranscoder.h"
+
+using CppSpec::Specification;
+
+class JsonTranscoderSpec : public Specification<std::stringstream, JsonTranscoderSpec> {
+public:
+    JsonTranscoderSpec() {
+        REGISTER_BEHAVIOUR(JsonTranscoderSpec, mappingsBecomeAnObject);
+        REGISTER_BEHAVIOUR(JsonTranscoderSpec, listItemsBecomeAnArray);
+        REGISTER_BEHAVIOUR(JsonTranscoderSpec, emptyDocumentBecomesAnEmptyObject);
+        REGISTER_BEHAVIOUR(JsonTranscoderSpec, quotedScalarsAreReescaped);
+        REGISTER_BEHAVIOUR(JsonTranscoderSpec, mixingMappingsAndListItemsIsAnError);
+    }
+
+    void mappingsBecomeAnObject() {
+        JsonTranscoder(context()).transcode("foo:bar\nbaz:zyx\ncount: 5");
+        specify(context().str(), should.equal("{\"foo\":\"bar\",\"baz\":\"zyx\",\"count\":5}"));
+    }
+
+    void listItemsBecomeAnArray() {
+        JsonTranscoder(context()).transcode("- first\n- second\n- third");
+        specify(context().str(), should.equal("[\"first\",\"second\",\"third\"]"));
+    }
+
+    void emptyDocumentBecomesAnEmptyObject() {
+        JsonTranscoder(context()).transcode("");
+        specify(context().str(), should.equal("{}"));
+    }
+
+    void quotedScalarsAreReescaped() {
+        JsonTranscoder(context()).transcode("'it''s': \"say \\\"hi\\\"\\t\"");
+        specify(context().str(), should.equal("{\"it's\":\"say \\\"hi\\\"\\t\"}"));
+    }
+
+    void mixingMappingsAndListItemsIsAnError() {
+        JsonTranscoder transcoder(context());
+        bool thrown = false;
+        try {
+            transcoder.transcode("foo:bar\n- first");
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        specify(thrown, should.equal(true));
+    }
+} jsonTranscoderSpec;
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef MERGEKEYSPEC_H
+#define MERGEKEYSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+#include "yamlpp/Emitter.h"
+#include "yamlpp/JsonTranscoder.h"
+
+using CppSpec::Specification;
+
+class MergeKeySpec : public Specification<Document, MergeKeySpec> {
+public:
+    MergeKeySpec() {
+        REGISTER_BEHAVIOUR(MergeKeySpec, canParseFlowMappings);
+        REGISTER_BEHAVIOUR(MergeKeySpec, onlyDecimalFlowScalarsAreNumbers);
+        REGISTER_BEHAVIOUR(MergeKeySpec, mergedKeysAreFoundThroughTheDocument);
+        REGISTER_BEHAVIOUR(MergeKeySpec, mappingsCanMergeMappings);
+        REGISTER_BEHAVIOUR(MergeKeySpec, mergedMappingsAreShared);
+        REGISTER_BEHAVIOUR(MergeKeySpec, flatteningCopiesMergedKeys);
+        REGISTER_BEHAVIOUR(MergeKeySpec, mergingAScalarThrows);
+        REGISTER_BEHAVIOUR(MergeKeySpec, mergedKeysAreEmitted);
+        REGISTER_BEHAVIOUR(MergeKeySpec, flowMappingsAreTranscodedToJson);
+        REGISTER_BEHAVIOUR(MergeKeySpec, editedMergeReplacesTheOldOne);
+    }
+
+    void canParseFlowMappings() {
+        parse_info<> info = context().parse("db: {host: db.local, port: 5432, \"user name\": 'a, b', opts: {ssl: on}}");
+        specify(info.full, should.equal(true));
+        Mapping db(context().valueAs<Mapping>("db"));
+        specify(db.valueAs<std::string>("host"), should.equal("db.local"));
+        specify(db.valueAs<int>("port"), should.equal(5432));
+        specify(db.valueAs<std::string>("user name"), should.equal("a, b"));
+        specify(db.valueAs<Mapping>("opts").valueAs<std::string>("ssl"), should.equal("on"));
+    }
+
+    void onlyDecimalFlowScalarsAreNumbers() {
+        context().parse("m: {a: -12, b: 0x1A, c: inf, d: nan, e: 1e3, f: .5}");
+        Mapping m(context().valueAs<Mapping>("m"));
+        specify(m.valueAs<int>("a"), should.equal(-12));
+        specify(m.valueAs<std::string>("b"), should.equal("0x1A"));
+        specify(m.valueAs<std::string>("c"), should.equal("inf"));
+        specify(m.valueAs<std::string>("d"), should.equal("nan"));
+        specify(m.valueAs<int>("e"), should.equal(1));
+        specify(m.valueAs<int>("f"), should.equal(0));
+    }
+
+    void mergedKeysAreFoundThroughTheDocument() {
+        context().parse("base: &base {host: db, port: 5432}\n<<: *base\nport: 6000");
+        specify(context().valueAs<std::string>("host"), should.equal("db"));
+        specify(context().valueAs<int>("port"), should.equal(6000));
+        specify(std::distance(context().begin(), context().end()), should.equal(2));
+    }
+
+    void mappingsCanMergeMappings() {
+        context().parse("base: &base {host: db, port: 5432}\nextra: &extra {debug: yes}\nstaging: {<<: *base, <<: *extra, port: 6000}");
+        Mapping staging(context().valueAs<Mapping>("staging"));
+        specify(staging.valueAs<std::string>("host"), should.equal("db"));
+        specify(staging.valueAs<std::string>("debug"), should.equal("yes"));
+        specify(staging.valueAs<int>("port"), should.equal(6000));
+    }
+
+    void mergedMappingsAreShared() {
+        context().parse("base: &base {host: db}\nstaging: {<<: *base}");
+        const boost::any* base = context().valueAs<const Mapping&>("base").find("host");
+        const boost::any* merged = context().valueAs<const Mapping&>("staging").find("host");
+        specify(base == merged, should.equal(true));
+    }
+
+    void flatteningCopiesMergedKeys() {
+        context().parse("base: &base {host: db}\n<<: *base");
+        context().flattenMerges();
+        specify(std::distance(context().begin(), context().end()), should.equal(2));
+        specify(context().valueAs<std::string>("host"), should.equal("db"));
+    }
+
+    void mergingAScalarThrows() {
+        specify(invoking(parse, std::string("name: &name text\n<<: *name")).should.raise.exception<std::runtime_error>("Merge key '<<' needs a mapping"));
+    }
+
+    void mergedKeysAreEmitted() {
+        context().parse("base: &base {host: db, port: 1}\n<<: *base\nport: 2");
+        specify(Emitter().emit(context()), should.equal("base: {host: db, port: 1}\nport: 2\nhost: db\n"));
+    }
+
+    void flowMappingsAreTranscodedToJson() {
+        std::stringstream out;
+        JsonTranscoder(out).transcode("db: &db {host: \"x\", port: 1, opts: {}}\ncopy: *db");
+        specify(out.str(), should.equal("{\"db\":{\"host\":\"x\",\"port\":1,\"opts\":{}},\"copy\":{\"host\":\"x\",\"port\":1,\"opts\":{}}}"));
+    }
+
+    void editedMergeReplacesTheOldOne() {
+        std::string data("a: &a {x: 1, y: 1}\nb: &b {x: 2}\n<<: *a\nz: {<<: {w: 1}}\n<<: {v: 1}\n");
+        context().parse(data);
+        context().edit(data, data.find("*a"), 2, "*b");
+        specify(context().valueAs<int>("x"), should.equal(2));
+        specify(context().tryGet<int>("y").is_initialized(), should.equal(false));
+        context().edit(data, data.find("{v: 1}"), 6, "{u: 1}");
+        specify(context().tryGet<int>("v").is_initialized(), should.equal(false));
+        specify(context().valueAs<int>("u"), should.equal(1));
+    }
+
+private:
+    typedef parse_info<> (Document::*Parse)(const std::string&);
+    static const Parse parse;
+} mergeKeySpec;
+
+const MergeKeySpec::Parse MergeKeySpec::parse = &Document::parse;
+
+#endif
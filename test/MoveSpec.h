@@ -0,0 +1,66 @@
+#ifndef MOVESPEC_H
+#define MOVESPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+
+using CppSpec::Specification;
+
+class MoveSpec : public Specification<Document, MoveSpec> {
+public:
+    MoveSpec() {
+        REGISTER_BEHAVIOUR(MoveSpec, movingADocumentDoesNotAllocate);
+        REGISTER_BEHAVIOUR(MoveSpec, movingAListDoesNotAllocate);
+        REGISTER_BEHAVIOUR(MoveSpec, listItemsAreNotCopiedWhileParsing);
+    }
+
+    Document* createContext() {
+        Document* doc = new Document();
+        doc->parse("foo:bar\ncount: 5\n- first\n- second");
+        return doc;
+    }
+
+    void movingADocumentDoesNotAllocate() {
+        AllocationCounter counter;
+        Document moved(std::move(context()));
+        Document assigned;
+        assigned = std::move(moved);
+
+        specify(counter.allocations, should.equal(0u));
+        specify(assigned.valueAs<std::string>("foo"), should.equal("bar"));
+        specify(assigned.list().count(), should.equal(2u));
+    }
+
+    void movingAListDoesNotAllocate() {
+        AllocationCounter counter;
+        List moved(std::move(context().list()));
+
+        specify(counter.allocations, should.equal(0u));
+        specify(moved.count(), should.equal(2u));
+        specify(context().list().count(), should.equal(0u));
+    }
+
+    // Items longer than the small string buffer need one allocation for
+    // the string and one for the boost::any holding it; a copy anywhere on
+    // the way into the list would add a third. The slack covers the list
+    // growing its storage.
+    void listItemsAreNotCopiedWhileParsing() {
+        size_t hundred = allocationsForItems(100);
+        size_t twoHundred = allocationsForItems(200);
+        specify(twoHundred - hundred <= 2 * 100 + 8, should.equal(true));
+    }
+
+private:
+    size_t allocationsForItems(size_t count) {
+        std::string data;
+        for (size_t i = 0; i < count; i++) {
+            data.append("- averylongitemthatisnotinlined\n");
+        }
+        Document document;
+        document.collectStats(true);
+        document.parse(data);
+        return document.stats().allocations;
+    }
+} moveSpec;
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef PARALLELPARSERSPEC_H
+#define PARALLELPARSERSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/ParallelParser.h"
+
+using CppSpec::Specification;
+
+class ParallelParserSpec : public Specification<ParallelParser, ParallelParserSpec> {
+public:
+    ParallelParserSpec() {
+        REGISTER_BEHAVIOUR(ParallelParserSpec, streamIsSplitIntoDocuments);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, documentsAreParsedSeparately);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, largeSequenceIsParsedInPieces);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, laterKeysReplaceEarlierOnes);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, errorIsPlacedInTheWholeInput);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, limitsCoverAllThePieces);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, unindentedContinuationsAreParsedInOnePiece);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, aliasesAreParsedInOnePiece);
+        REGISTER_BEHAVIOUR(ParallelParserSpec, executorCanBeInjected);
+    }
+
+    ParallelParser* createContext() {
+        return new ParallelParser(pool());
+    }
+
+    void streamIsSplitIntoDocuments() {
+        std::string stream("---\na: 1\n--- \nb: 2\n---x: 3\n---\n");
+        std::vector<ParallelParser::Range> ranges(ParallelParser::splitDocuments(stream.c_str(), stream.c_str() + stream.size()));
+        specify(ranges.size(), should.equal(3u));
+        specify(std::string(ranges[1].first, ranges[1].second), should.equal(" \nb: 2\n---x: 3\n"));
+        specify(std::string(ranges[2].first, ranges[2].second), should.equal("\n"));
+    }
+
+    void documentsAreParsedSeparately() {
+        std::string stream("a: 1\n---\nb: 2\n- item\n---\nbroken\n");
+        std::vector<Document> documents(context().parseAll(stream));
+        specify(documents.size(), should.equal(3u));
+        specify(documents[0].valueAs<int>("a"), should.equal(1));
+        specify(documents[0].tryGet<int>("b").is_initialized(), should.equal(false));
+        specify(documents[1].list().valueAs<std::string>(0), should.equal("item"));
+        specify(documents[2].error().ok(), should.equal(false));
+        specify(documents[2].error().line(), should.equal(2u));
+    }
+
+    void largeSequenceIsParsedInPieces() {
+        std::string data("name: items\n");
+        for (int i = 0; i < 5000; i++) {
+            data += "- item\n";
+        }
+        data += "count: 5000\n";
+        Document document;
+        parse_info<> info = context().parse(data, document, 1000);
+        specify(info.full, should.equal(true));
+        specify(document.list().count(), should.equal(5000u));
+        specify(document.valueAs<int>("count"), should.equal(5000));
+        specify(document.valueAs<std::string>("name"), should.equal("items"));
+        specify(std::distance(document.begin(), document.end()), should.equal(3));
+    }
+
+    void laterKeysReplaceEarlierOnes() {
+        std::string data;
+        for (int i = 0; i < 1000; i++) {
+            data += "key: " + std::to_string(i) + "\n";
+        }
+        Document document;
+        context().parse(data, document, 100);
+        specify(document.valueAs<int>("key"), should.equal(999));
+    }
+
+    void errorIsPlacedInTheWholeInput() {
+        std::string data;
+        for (int i = 0; i < 1000; i++) {
+            data += i == 700 ? "broken\n" : "key" + std::to_string(i) + ": value\n";
+        }
+        Document document;
+        parse_info<> info = context().parse(data, document, 500);
+        specify(info.full, should.equal(false));
+        specify(document.error().line(), should.equal(701u));
+        specify(document.valueAs<std::string>("key699"), should.equal("value"));
+    }
+
+    void limitsCoverAllThePieces() {
+        std::string data;
+        for (int i = 0; i < 1000; i++) {
+            data += "key" + std::to_string(i) + ": value\n";
+        }
+        ParseLimits limits;
+        limits.nodes = 500;
+        Document document;
+        document.parseLimits(limits);
+        bool exceeded = false;
+        try {
+            context().parse(data, document, 100);
+        } catch (const LimitExceededException& e) {
+            exceeded = e.limit() == LimitExceededException::Nodes;
+        }
+        specify(exceeded, should.equal(true));
+        specify(document.begin() == document.end(), should.equal(true));
+    }
+
+    void unindentedContinuationsAreParsedInOnePiece() {
+        const char* datas[] = {"m: {x: 1,\ny: 2}\nname: server\n", "q: \"first\nsecond line\"\nname: server\n"};
+        for (size_t i = 0; i < 2; i++) {
+            Document serial;
+            specify(serial.parse(datas[i]).full, should.equal(true));
+            Document document;
+            specify(context().parse(datas[i], document, 8).full, should.equal(true));
+            specify(std::distance(document.begin(), document.end()), should.equal(2));
+            specify(document.valueAs<std::string>("name"), should.equal("server"));
+            if (i == 0) {
+                specify(document.valueAs<Mapping>("m").valueAs<int>("y"), should.equal(2));
+            }
+        }
+    }
+
+    void aliasesAreParsedInOnePiece() {
+        std::string data("base: &b value\n");
+        for (int i = 0; i < 1000; i++) {
+            data += "- *b\n";
+        }
+        Document document;
+        specify(context().parse(data, document, 100).full, should.equal(true));
+        specify(document.list().valueAs<std::string>(999), should.equal("value"));
+    }
+
+    void executorCanBeInjected() {
+        CountingExecutor executor;
+        std::vector<Document> documents(ParallelParser(executor).parseAll("a: 1\n---\nb: 2\n"));
+        specify(executor.tasks, should.equal(2u));
+        specify(documents[1].valueAs<int>("b"), should.equal(2));
+    }
+
+private:
+    struct CountingExecutor : public InlineExecutor {
+        CountingExecutor() : tasks(0) {}
+
+        void run(const std::vector<SizedTask>& batch) {
+            tasks += batch.size();
+            InlineExecutor::run(batch);
+        }
+
+        size_t tasks;
+    };
+
+    static WorkStealingPool& pool() {
+        static WorkStealingPool pool(4);
+        return pool;
+    }
+} parallelParserSpec;
+
+#endif
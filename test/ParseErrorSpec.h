@@ -0,0 +1,74 @@
+#ifndef PARSEERRORSPEC_H
+#define PARSEERRORSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+
+using CppSpec::Specification;
+
+class ParseErrorSpec : public Specification<Document, ParseErrorSpec> {
+public:
+    ParseErrorSpec() {
+        REGISTER_BEHAVIOUR(ParseErrorSpec, successfulParseHasNoError);
+        REGISTER_BEHAVIOUR(ParseErrorSpec, errorHasLineColumnAndContext);
+        REGISTER_BEHAVIOUR(ParseErrorSpec, errorTellsWhatWasExpected);
+        REGISTER_BEHAVIOUR(ParseErrorSpec, invalidUtf8IsReported);
+        REGISTER_BEHAVIOUR(ParseErrorSpec, newlinesAreCountedAcrossLongInput);
+        REGISTER_BEHAVIOUR(ParseErrorSpec, keyPositionsCanBeRecorded);
+    }
+
+    void successfulParseHasNoError() {
+        context().parse("foo: bar");
+        specify(context().error().ok(), should.equal(true));
+        specify(context().error().message(), should.equal(""));
+    }
+
+    void errorHasLineColumnAndContext() {
+        std::string data("foo: bar\n# comment\n  baz zyx\nnum: 1");
+        context().parse(data);
+        const ParseError& error = context().error();
+        specify(error.ok(), should.equal(false));
+        specify(error.line(), should.equal(3u));
+        specify(error.column(), should.equal(3u));
+        specify(error.offset(), should.equal(21u));
+        specify(error.context(), should.equal("  baz zyx"));
+        specify(error.message(), should.equal("Expected ':' after a key at line 3, column 3:   baz zyx"));
+    }
+
+    void errorTellsWhatWasExpected() {
+        std::string data("foo: bar\nkey: ]");
+        context().parse(data);
+        specify(context().error().expected(), should.equal("a value after ':'"));
+    }
+
+    void invalidUtf8IsReported() {
+        std::string data("foo: bar\nbad: \xff");
+        context().parse(data);
+        specify(context().error().expected(), should.equal("valid UTF-8"));
+        specify(context().error().column(), should.equal(6u));
+    }
+
+    void newlinesAreCountedAcrossLongInput() {
+        std::string data;
+        for (int i = 0; i < 1000; i++) {
+            data += "key" + std::to_string(i) + ": value\n";
+        }
+        data += "broken";
+        context().parse(data);
+        specify(context().error().line(), should.equal(1001u));
+        specify(context().error().column(), should.equal(1u));
+    }
+
+    void keyPositionsCanBeRecorded() {
+        std::string data("foo: bar\n\n  baz: 3\n# note\n\"quoted\": x");
+        context().recordPositions(true);
+        context().parse(data);
+        specify(context().position("foo").line, should.equal(1u));
+        specify(context().position("baz").line, should.equal(3u));
+        specify(context().position("baz").column, should.equal(3u));
+        specify(context().position("quoted").line, should.equal(5u));
+        specify(context().position("quoted").column, should.equal(1u));
+    }
+} parseErrorSpec;
+
+#endif
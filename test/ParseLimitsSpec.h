@@ -0,0 +1,136 @@
+#ifndef PARSELIMITSSPEC_H
+#define PARSELIMITSSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+
+using CppSpec::Specification;
+
+class ParseLimitsSpec : public Specification<Document, ParseLimitsSpec> {
+public:
+    ParseLimitsSpec() {
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, documentWithinLimitsIsParsed);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, nestingIsLimited);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, listItemsAreOneLevelDeeper);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, nodesAreLimited);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, scalarLengthIsLimited);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, bytesAreLimited);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, deadlineIsEnforced);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, exceededDocumentIsLeftEmpty);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, documentLimitsApplyToEveryParse);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, aliasLimitIsALimit);
+        REGISTER_BEHAVIOUR(ParseLimitsSpec, deepFlowMappingFailsToParse);
+    }
+
+    void documentWithinLimitsIsParsed() {
+        ParseLimits limits;
+        limits.depth = 2;
+        limits.nodes = 3;
+        limits.scalar_length = 8;
+        parse_info<> info = context().parse("a: {b: 1}\nc: text", limits);
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<std::string>("c"), should.equal("text"));
+    }
+
+    void nestingIsLimited() {
+        ParseLimits limits;
+        limits.depth = 2;
+        specify(invoking(parse, std::string("a: {b: {c: 1}}"), limits).should.raise.exception<LimitExceededException>("Document is nested deeper than 2 levels."));
+    }
+
+    void listItemsAreOneLevelDeeper() {
+        ParseLimits limits;
+        limits.depth = 1;
+        specify(invoking(parse, std::string("- item"), limits).should.raise.exception<LimitExceededException>("Document is nested deeper than 1 levels."));
+    }
+
+    void nodesAreLimited() {
+        ParseLimits limits;
+        limits.nodes = 3;
+        specify(invoking(parse, std::string("a: 1\nb: {c: x, d: y}"), limits).should.raise.exception<LimitExceededException>("Document has more than 3 nodes."));
+    }
+
+    void scalarLengthIsLimited() {
+        ParseLimits limits;
+        limits.scalar_length = 4;
+        specify(invoking(parse, std::string("a: {b: \"longer\"}"), limits).should.raise.exception<LimitExceededException>("Document has a scalar longer than 4 bytes."));
+        specify(invoking(parse, std::string("longer: 1"), limits).should.raise.exception<LimitExceededException>("Document has a scalar longer than 4 bytes."));
+    }
+
+    void bytesAreLimited() {
+        ParseLimits limits;
+        limits.bytes = 1000;
+        std::string data;
+        for (int i = 0; i < 100; i++) {
+            data += "- item\n";
+        }
+        specify(invoking(parse, data, limits).should.raise.exception<LimitExceededException>("Document needs more than 1000 bytes."));
+    }
+
+    void deadlineIsEnforced() {
+        ParseLimits limits;
+        limits.deadline = ParseLimits::Clock::now() - std::chrono::seconds(1);
+        try {
+            context().parse("a: 1", limits);
+            specify(false, should.equal(true));
+        } catch (const LimitExceededException& e) {
+            specify(e.limit() == LimitExceededException::Deadline, should.equal(true));
+        }
+    }
+
+    void exceededDocumentIsLeftEmpty() {
+        context().parse("kept: 1");
+        ParseLimits limits;
+        limits.nodes = 10;
+        std::string data("a: &a x\n");
+        for (int i = 0; i < 20; i++) {
+            data += "key" + std::to_string(i) + ": *a\n";
+        }
+        try {
+            context().parse(data, limits);
+            specify(false, should.equal(true));
+        } catch (const LimitExceededException& e) {
+            specify(e.limit() == LimitExceededException::Nodes, should.equal(true));
+        }
+        specify(context().begin() == context().end(), should.equal(true));
+        specify(context().tryGet<std::string>("a").is_initialized(), should.equal(false));
+    }
+
+    void documentLimitsApplyToEveryParse() {
+        ParseLimits limits;
+        limits.nodes = 1;
+        context().parseLimits(limits);
+        specify(context().parse("a: 1").full, should.equal(true));
+        specify(invoking(plainParse, std::string("a: 1\nb: 2")).should.raise.exception<LimitExceededException>("Document has more than 1 nodes."));
+    }
+
+    void aliasLimitIsALimit() {
+        context().aliasLimit(1);
+        try {
+            context().parse("a: &a x\nb: *a\nc: *a");
+            specify(false, should.equal(true));
+        } catch (const LimitExceededException& e) {
+            specify(e.limit() == LimitExceededException::Aliases, should.equal(true));
+        }
+        specify(context().parseLimits().aliases, should.equal(1u));
+    }
+
+    void deepFlowMappingFailsToParse() {
+        std::string data("a: ");
+        data += std::string(100000, '{');
+        parse_info<> info = context().parse(data);
+        specify(info.full, should.equal(false));
+    }
+
+private:
+    typedef parse_info<> (Document::*Parse)(const std::string&, const ParseLimits&);
+    static const Parse parse;
+
+    typedef parse_info<> (Document::*PlainParse)(const std::string&);
+    static const PlainParse plainParse;
+} parseLimitsSpec;
+
+const ParseLimitsSpec::Parse ParseLimitsSpec::parse = &Document::parse;
+const ParseLimitsSpec::PlainParse ParseLimitsSpec::plainParse = &Document::parse;
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef PARSESTATSSPEC_H
+#define PARSESTATSSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+#include "yamlpp/PushParser.h"
+
+using CppSpec::Specification;
+
+class ParseStatsSpec : public Specification<Document, ParseStatsSpec> {
+public:
+    ParseStatsSpec() {
+        REGISTER_BEHAVIOUR(ParseStatsSpec, statsAreNotCollectedByDefault);
+        REGISTER_BEHAVIOUR(ParseStatsSpec, allocationsOfAParseAreCounted);
+        REGISTER_BEHAVIOUR(ParseStatsSpec, registryAccumulatesParses);
+        REGISTER_BEHAVIOUR(ParseStatsSpec, streamIsCountedAsOneParse);
+    }
+
+    void statsAreNotCollectedByDefault() {
+        context().parse("foo:bar\nbaz:zyx\ncount: 5");
+        specify(context().stats().allocations, should.equal(0u));
+    }
+
+    void allocationsOfAParseAreCounted() {
+        context().collectStats(true);
+        context().parse("foo:bar\nbaz:zyx\ncount: 5");
+        const ParseStats& stats = context().stats();
+        specify(stats.allocations > 0, should.equal(true));
+        specify(stats.bytes >= stats.peak_bytes, should.equal(true));
+        specify(stats.peak_bytes > 0, should.equal(true));
+    }
+
+    void registryAccumulatesParses() {
+        ParseStatsRegistry& registry(ParseStatsRegistry::global());
+        registry.reset();
+        registry.enable(true);
+        context().parse("foo:bar");
+        Document other;
+        other.parse("- first\n- second");
+        registry.enable(false);
+        context().parse("baz:zyx");
+
+        specify(registry.parses(), should.equal(2u));
+        specify(registry.totals().allocations, should.equal(context().stats().allocations + other.stats().allocations));
+    }
+
+    void streamIsCountedAsOneParse() {
+        const char* lines[] = {"foo:bar\n", "baz:zyx\n", "count: 5\n", "- first\n", "- second\n"};
+        std::string text;
+        for (size_t i = 0; i < 5; i++) {
+            text += lines[i];
+        }
+        context().collectStats(true);
+        context().parse(text);
+        ParseStatsRegistry& registry(ParseStatsRegistry::global());
+        registry.reset();
+        registry.enable(true);
+        Document streamed;
+        PushParser parser(streamed);
+        for (size_t i = 0; i < 5; i++) {
+            parser.feed(lines[i], std::strlen(lines[i]));
+        }
+        parser.finish();
+        registry.enable(false);
+
+        specify(registry.parses(), should.equal(1u));
+        specify(registry.totals().allocations, should.equal(streamed.stats().allocations));
+        specify(streamed.stats().allocations, should.equal(context().stats().allocations));
+    }
+} parseStatsSpec;
+
+#endif
@@ -1,150 +1,10 @@
+#ifndef PARSERSPEC_H
+#define PARSERSPEC_H
+
 #include <CppSpec/CppSpec.h>
-#include <boost/spirit.hpp>
-#include <boost/function.hpp>
-#include <boost/any.hpp>
-#include <map>
-#include <ctime>
+#include "yamlpp/Document.h"
 
 using CppSpec::Specification;
-using namespace boost::spirit;
-
-typedef boost::function2<void, const char*, const char*> grammar_cb;
-
-struct YamlGrammar : public grammar<YamlGrammar> {
-    YamlGrammar(grammar_cb& identifier, grammar_cb& string_value, grammar_cb& num_value, grammar_cb& list_item) : identifier(identifier), string_value(string_value),
-    num_value(num_value), list_item(list_item) {
-    }
-
-    template<class ScannerT>
-    struct definition {
-        rule<ScannerT> property_id;
-        rule<ScannerT> string_value;
-        rule<ScannerT> num_value;
-        rule<ScannerT> property;
-        rule<ScannerT> list_item;
-        rule<ScannerT> yaml_line;
-        rule<ScannerT> yaml_document;
-
-        definition(const YamlGrammar& self) {
-            property_id = lexeme_d[+alnum_p];
-            string_value = lexeme_d[+alpha_p];
-            num_value = real_p;
-            property = property_id[self.identifier] >> ch_p(':') >> (num_value[self.num_value] | string_value[self.string_value]);
-            list_item = ch_p('-') >> lexeme_d[*alnum_p][self.list_item];
-            yaml_line = (list_item | property);
-            yaml_document = *yaml_line;
-        }
-
-        const rule<ScannerT>& start() {return yaml_document;}
-    };
-
-    grammar_cb& identifier;
-    grammar_cb& string_value;
-    grammar_cb& num_value;
-    grammar_cb& list_item;
-};
-
-class List {
-public:
-    List() : list() {}
-    List(const List& that) : list() {list.assign(that.list.begin(), that.list.end());}
-    ~List() {}
-
-    template<class T>
-    T& valueAs(size_t index) {
-        return boost::any_cast<T&>(list[index]);
-    }
-
-    void add(const boost::any& item) {
-        list.push_back(item);
-    }
-
-    size_t count() const {return list.size();}
-
-private:
-    List& operator=(const List&);
-
-private:
-    std::vector<boost::any> list;
-};
-
-class ScalarNotFoundException : public std::runtime_error {
-public:
-    explicit ScalarNotFoundException(const std::string& reason)
-    : std::runtime_error("Scalar '" + reason + "' not found.") {}
-};
-
-class Document {
-public:
-    Document() : values(), current_id() {}
-
-    parse_info<> parse(const std::string& data) {
-        grammar_cb id_f(bind(&Document::id, this, _1, _2));
-        grammar_cb value_f(bind(&Document::value, this, _1, _2));
-        grammar_cb num_value_f(bind(&Document::num_value, this, _1, _2));
-        grammar_cb list_item_f(bind(&Document::list_item, this, _1, _2));
-        YamlGrammar grammar(id_f, value_f, num_value_f, list_item_f);
-        return boost::spirit::parse(data.c_str(), grammar >> eps_p, space_p);
-    }
-
-    template<class T>
-    T valueAs(const std::string& key) {
-        std::map<std::string, boost::any>::iterator it(values.find(key));
-        if (it == values.end()) {
-            throw ScalarNotFoundException(key);
-        }
-        return boost::any_cast<T>(it->second);
-    }
-
-    List& list() {
-        for (std::map<std::string, boost::any>::iterator it = values.begin(); it != values.end(); it++) {
-            if (it->second.type() == typeid(List)) {
-                return boost::any_cast<List&>(it->second);
-            }
-        }
-        throw std::string("List not found");
-    }
-
-private:
-    void id(const char* start, const char* end) {
-        current_id = std::string(start, end);
-    }
-
-    void value(const char* start, const char* end) {
-        values[current_id] = boost::any(std::string(start, end));
-    }
-
-    void num_value(const char* start, const char* end) {
-        int value(atoi(std::string(start, end).c_str()));
-        values[current_id] = boost::any(value);
-    }
-
-    void list_item(const char* start, const char* end) {
-        List& list = getOrCreateList();
-        list.add(boost::any(std::string(start, end)));
-    }
-
-    List& getOrCreateList() {
-        boost::any& current = values[current_id];
-        if (current.type() != typeid(List)) {
-            current_id = timeStamp();
-            List list;
-            values[current_id] = boost::any(list);
-            return boost::any_cast<List&>(values[current_id]);
-        }
-        return boost::any_cast<List&>(current);
-    }
-
-    std::string timeStamp() const {
-        std::stringstream stamp;
-        stamp << "list-" << ::time(NULL);
-        return stamp.str();
-    }
-
-private:
-    std::map<std::string, boost::any> values;
-    std::string current_id;
-};
 
 class ScalarParserSpec : public Specification<Document, ScalarParserSpec> {
 public:
@@ -194,3 +54,105 @@ public:
         specify(list.valueAs<std::string>(2), should.equal("third"));
     }
 } listParserSpec;
+
+class IncrementalParseSpec : public Specification<Document, IncrementalParseSpec> {
+public:
+    IncrementalParseSpec() {
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, editedScalarIsReparsed);
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, removedMappingDisappears);
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, editedListItemIsReparsed);
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, dashInsideALineIsNotAListItem);
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, blockScalarWithBlankLinesIsReparsedWhole);
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, insertedListItemJoinsTheList);
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, redefinedKeysMatchAFullParse);
+        REGISTER_BEHAVIOUR(IncrementalParseSpec, editedKeysLoseTheirCommentsAndPositions);
+    }
+
+    void editedScalarIsReparsed() {
+        std::string data("foo:bar\nbaz:zyx\ncount: 5");
+        context().parse(data);
+        context().edit(data, 4, 3, "qux");
+        specify(data, should.equal("foo:qux\nbaz:zyx\ncount: 5"));
+        specify(context().valueAs<std::string>("foo"), should.equal("qux"));
+        specify(context().valueAs<std::string>("baz"), should.equal("zyx"));
+        specify(context().valueAs<int>("count"), should.equal(5));
+    }
+
+    void removedMappingDisappears() {
+        std::string data("foo:bar\nbaz:zyx\ncount: 5");
+        context().parse(data);
+        context().edit(data, 8, 8, "");
+        specify(invoking(&Document::valueAs<std::string>, "baz").should.raise.exception<ScalarNotFoundException>("Scalar 'baz' not found."));
+        specify(context().valueAs<int>("count"), should.equal(5));
+    }
+
+    void editedListItemIsReparsed() {
+        std::string data("- first\n- second\n- third");
+        context().parse(data);
+        context().edit(data, 10, 6, "changed\n- inserted");
+        List& list = context().list();
+
+        specify(list.count(), should.equal(4u));
+        specify(list.valueAs<std::string>(0), should.equal("first"));
+        specify(list.valueAs<std::string>(1), should.equal("changed"));
+        specify(list.valueAs<std::string>(2), should.equal("inserted"));
+        specify(list.valueAs<std::string>(3), should.equal("third"));
+    }
+
+    void dashInsideALineIsNotAListItem() {
+        std::string data("- a\n- b\nx: 1\ncount: 5\n");
+        context().parse(data);
+        specify(context().edit(data, data.find('5'), 1, "-5").full, should.equal(true));
+        specify(context().list().count(), should.equal(2u));
+        specify(context().valueAs<int>("count"), should.equal(-5));
+    }
+
+    void blockScalarWithBlankLinesIsReparsedWhole() {
+        std::string data("cert: |\n  line1\n\n  line2\nx: 1\n");
+        context().parse(data);
+        specify(context().edit(data, data.find("line2"), 5, "other").full, should.equal(true));
+        specify(context().valueAs<std::string>("cert"), should.equal("line1\n\nother\n"));
+        specify(context().valueAs<int>("x"), should.equal(1));
+    }
+
+    void insertedListItemJoinsTheList() {
+        std::string data("- a\n- b\nk: 1\n");
+        context().parse(data);
+        context().edit(data, 0, 0, "- z\n");
+        specify(context().list().count(), should.equal(3u));
+        specify(context().list().valueAs<std::string>(0), should.equal("z"));
+    }
+
+    void redefinedKeysMatchAFullParse() {
+        std::string data("a: x\nb: y\n");
+        context().parse(data);
+        context().edit(data, 0, 1, "b");
+        specify(context().valueAs<std::string>("b"), should.equal("y"));
+        specify(context().find("a") == 0, should.equal(true));
+        Document twice;
+        data = "a: x\nb: y\na: z\n";
+        twice.parse(data);
+        twice.edit(data, 3, 1, "q");
+        specify(twice.valueAs<std::string>("a"), should.equal("z"));
+    }
+
+    void editedKeysLoseTheirCommentsAndPositions() {
+        std::string data("#about a\na: x\nb: y\n");
+        context().keepComments(true);
+        context().recordPositions(true);
+        context().parse(data);
+        context().edit(data, 9, 1, "c");
+        specify(context().comment("a"), should.equal(""));
+        specify(context().comment("c"), should.equal("about a"));
+        specify(context().position("c").line, should.equal(2u));
+        bool stale = true;
+        try {
+            context().position("a");
+        } catch (const ScalarNotFoundException&) {
+            stale = false;
+        }
+        specify(stale, should.equal(false));
+    }
+} incrementalParseSpec;
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef PATCHSPEC_H
+#define PATCHSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Patch.h"
+#include "yamlpp/Emitter.h"
+
+using CppSpec::Specification;
+
+class PatchSpec : public Specification<Document, PatchSpec> {
+public:
+    PatchSpec() {
+        REGISTER_BEHAVIOUR(PatchSpec, pathsAreCompiledFromPointers);
+        REGISTER_BEHAVIOUR(PatchSpec, malformedPathsAreRejected);
+        REGISTER_BEHAVIOUR(PatchSpec, keysAreAddedReplacedAndRemoved);
+        REGISTER_BEHAVIOUR(PatchSpec, nestedMappingsArePatchedInPlace);
+        REGISTER_BEHAVIOUR(PatchSpec, listItemsAreInsertedAndRemoved);
+        REGISTER_BEHAVIOUR(PatchSpec, valuesAreMoved);
+        REGISTER_BEHAVIOUR(PatchSpec, failedPatchLeavesDocumentAsItWas);
+        REGISTER_BEHAVIOUR(PatchSpec, anchoredAndMergedValuesAreCopiedBeforeChanging);
+        REGISTER_BEHAVIOUR(PatchSpec, failedPatchPutsAliasesAndMergedKeysBack);
+        REGISTER_BEHAVIOUR(PatchSpec, patchedMappingsAreHashedAgain);
+        REGISTER_BEHAVIOUR(PatchSpec, patchBetweenDocumentsTurnsOneIntoTheOther);
+    }
+
+    void pathsAreCompiledFromPointers() {
+        CompiledPath path("/a~1b/c~0d/12/-/");
+        specify(path.size(), should.equal(5u));
+        specify(path[0].key, should.equal("a/b"));
+        specify(path[1].key, should.equal("c~d"));
+        specify(path[2].index, should.equal(12u));
+        specify(path[3].index, should.equal(CompiledPath::endIndex));
+        specify(path[4].key, should.equal(""));
+        specify(CompiledPath("/012")[0].index, should.equal(CompiledPath::noIndex));
+        specify(CompiledPath("/a").contains(CompiledPath("/a/b")), should.equal(true));
+        specify(CompiledPath("/a/b").contains(CompiledPath("/a")), should.equal(false));
+    }
+
+    void malformedPathsAreRejected() {
+        specify(failure([] {CompiledPath("a/b");}), should.equal("Path 'a/b' does not start with '/'"));
+        specify(failure([] {CompiledPath("/a~2");}), should.equal("Path '/a~2' has a ~ that is not followed by 0 or 1"));
+        specify(failure([] {Patch().remove("");}), should.equal("The whole document cannot be patched"));
+    }
+
+    void keysAreAddedReplacedAndRemoved() {
+        context().parse("name: server\nport: 80\ndebug: yes\n");
+        Patch().add("/host", "example").replace("/port", 8080).remove("/debug").apply(context());
+        specify(context().valueAs<std::string>("host"), should.equal("example"));
+        specify(context().valueAs<int>("port"), should.equal(8080));
+        specify(context().find("debug") == 0, should.equal(true));
+        specify(failure([this] {Patch().replace("/missing", 1).apply(context());}), should.equal("Path /missing is not there"));
+        specify(failure([this] {Patch().remove("/missing").apply(context());}), should.equal("Path /missing is not there"));
+    }
+
+    void nestedMappingsArePatchedInPlace() {
+        context().parse("db: {host: local, opts: {ssl: on}}\n");
+        Patch().replace("/db/opts/ssl", "off").add("/db/opts/timeout", 5).remove("/db/host").apply(context());
+        specify(Emitter().emit(context()), should.equal("db: {opts: {ssl: off, timeout: 5}}\n"));
+        specify(failure([this] {Patch().add("/db/missing/key", 1).apply(context());}), should.equal("Path /db/missing/key goes through a key that is not there"));
+        specify(failure([this] {Patch().add("/db/opts/ssl/key", 1).apply(context());}), should.equal("Path /db/opts/ssl/key goes through a value that is not a list or mapping"));
+    }
+
+    void listItemsAreInsertedAndRemoved() {
+        context().parse("- one\n- two\n- three\n");
+        Patch().add("/-/1", "inserted").add("/-/-", "last").remove("/-/0").replace("/-/1", "second").apply(context());
+        specify(Emitter().emit(context()), should.equal("- inserted\n- second\n- three\n- last\n"));
+        specify(failure([this] {Patch().add("/-/9", "x").apply(context());}), should.equal("Path /-/9 is past the end of the list"));
+        Patch().remove("/-").apply(context());
+        specify(context().findList() == 0, should.equal(true));
+        List items;
+        items.add(std::string("new"));
+        Patch().add("/-", items).apply(context());
+        specify(context().list().valueAs<std::string>(0), should.equal("new"));
+    }
+
+    void valuesAreMoved() {
+        context().parse("a: {x: 1}\nb: {}\n- one\n- two\n- three\n");
+        Patch().move("/a/x", "/b/y").move("/-/0", "/-/-").move("/-/0", "/c").apply(context());
+        specify(Emitter().emit(context()), should.equal("a: {}\nb: {y: 1}\nc: two\n- three\n- one\n"));
+        specify(failure([this] {Patch().move("/b", "/b/z").apply(context());}), should.equal("Cannot move /b into itself"));
+    }
+
+    void failedPatchLeavesDocumentAsItWas() {
+        std::string data("a: {x: 1, y: 2}\nb: two\nc: three\n- one\n- two\n");
+        context().parse(data);
+        Document original(context());
+        Patch patch(Patch().add("/a/z", 3).remove("/b").replace("/c", "changed").move("/a/x", "/-/0").move("/-/2", "/c")
+            .remove("/-/1").add("/-/-", "end").replace("/missing", 0));
+        specify(failure([this, &patch] {patch.apply(context());}), should.equal("Path /missing is not there"));
+        specify(Diff::compare(original, context()).size(), should.equal(0u));
+        specify(Emitter().emit(context()), should.equal(Emitter().emit(original)));
+    }
+
+    void anchoredAndMergedValuesAreCopiedBeforeChanging() {
+        context().parse("base: &base {host: db, opts: {ssl: on}}\nother: *base\n<<: *base\n");
+        Patch().replace("/other/host", "elsewhere").replace("/opts/ssl", "off").apply(context());
+        specify(context().valueAs<Mapping>("base").valueAs<std::string>("host"), should.equal("db"));
+        specify(context().valueAs<Mapping>("base").valueAs<Mapping>("opts").valueAs<std::string>("ssl"), should.equal("on"));
+        specify(context().valueAs<Mapping>("other").valueAs<std::string>("host"), should.equal("elsewhere"));
+        specify(context().valueAs<Mapping>("opts").valueAs<std::string>("ssl"), should.equal("off"));
+        specify(failure([this] {Patch().remove("/host").apply(context());}), should.equal("Path /host is merged from another mapping"));
+    }
+
+    void failedPatchPutsAliasesAndMergedKeysBack() {
+        context().parse("base: &base {host: db, opts: {ssl: on}}\nother: *base\nnested: {<<: *base, port: 1}\n<<: *base\n- *base\n");
+        std::string before(Emitter().emit(context()));
+        Patch patch(Patch().replace("/other/host", "elsewhere").replace("/opts/ssl", "off").add("/nested/opts/timeout", 5)
+            .remove("/-/0/host").replace("/missing", 0));
+        specify(failure([this, &patch] {patch.apply(context());}), should.equal("Path /missing is not there"));
+        specify(context().find("other")->type() == typeid(Alias), should.equal(true));
+        specify(context().list().modify(0).type() == typeid(Alias), should.equal(true));
+        specify(ownKeys(context()), should.equal("base nested other"));
+        specify(ownKeys(context().valueAs<Mapping>("nested")), should.equal("port"));
+        specify(Emitter().emit(context()), should.equal(before));
+    }
+
+    void patchedMappingsAreHashedAgain() {
+        context().parse("a: {b: {c: 1}}\n");
+        Document copy(context());
+        boost::uint64_t before = structuralHash(*context().find("a"));
+        Patch().replace("/a/b/c", 2).apply(context());
+        specify(structuralHash(*context().find("a")) == before, should.equal(false));
+        specify(describe(Diff::compare(copy, context())), should.equal("~/a/b/c"));
+    }
+
+    void patchBetweenDocumentsTurnsOneIntoTheOther() {
+        context().parse("name: server\nport: 80\nold: x\nopts: {ssl: on, retry: 3}\n- one\n- two\n- three\n- four\n");
+        Document after;
+        after.parse("name: server\nport: 8080\nnew: y\nopts: {ssl: off, retry: 3}\n- one\n- six\n");
+        Patch patch(Patch::between(context(), after));
+        specify(patch.size(), should.equal(7u));
+        patch.apply(context());
+        specify(Diff::compare(context(), after).size(), should.equal(0u));
+    }
+
+private:
+    template<class F>
+    static std::string failure(const F& f) {
+        try {
+            f();
+        } catch (const PatchException& error) {
+            return error.what();
+        }
+        return std::string();
+    }
+
+    template<class Container>
+    static std::string ownKeys(const Container& container) {
+        std::string keys;
+        for (typename Container::const_iterator it = container.begin(); it != container.end(); it++) {
+            if (it->second.type() != typeid(List)) {
+                keys += (keys.empty() ? "" : " ") + it->first;
+            }
+        }
+        return keys;
+    }
+
+    static std::string describe(const std::vector<Change>& changes) {
+        static const char kinds[] = "+-~";
+        std::string out;
+        for (size_t i = 0; i < changes.size(); i++) {
+            out += (i ? " " : "") + std::string(1, kinds[changes[i].kind]) + changes[i].path;
+        }
+        return out;
+    }
+} patchSpec;
+
+#endif
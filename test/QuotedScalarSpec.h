@@ -0,0 +1,63 @@
+#ifndef QUOTEDSCALARSPEC_H
+#define QUOTEDSCALARSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+#include "yamlpp/Emitter.h"
+
+using CppSpec::Specification;
+
+class QuotedScalarSpec : public Specification<Document, QuotedScalarSpec> {
+public:
+    QuotedScalarSpec() {
+        REGISTER_BEHAVIOUR(QuotedScalarSpec, canParseQuotedScalars);
+        REGISTER_BEHAVIOUR(QuotedScalarSpec, escapesAreDecoded);
+        REGISTER_BEHAVIOUR(QuotedScalarSpec, escapesUtf8CannotEncodeAreReplaced);
+        REGISTER_BEHAVIOUR(QuotedScalarSpec, escapeFreeQuotedScalarsCostNoMoreThanPlainOnes);
+        REGISTER_BEHAVIOUR(QuotedScalarSpec, emittedStringsParseBack);
+    }
+
+    void canParseQuotedScalars() {
+        parse_info<> info = context().parse("foo: \"bar baz\"\n'key two': 'it''s'\n- \"a: b\"\n- plain");
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<std::string>("foo"), should.equal("bar baz"));
+        specify(context().valueAs<std::string>("key two"), should.equal("it's"));
+        specify(context().list().valueAs<std::string>(0), should.equal("a: b"));
+        specify(context().list().valueAs<std::string>(1), should.equal("plain"));
+    }
+
+    void escapesAreDecoded() {
+        context().parse("text: \"tab\\there \\\"quoted\\\" \\\\ \\x41\\u00c4\\U0001F600\\n\"\nsingle: 'no \\n escapes'");
+        specify(context().valueAs<std::string>("text"), should.equal("tab\there \"quoted\" \\ A\xc3\x84\xf0\x9f\x98\x80\n"));
+        specify(context().valueAs<std::string>("single"), should.equal("no \\n escapes"));
+    }
+
+    void escapesUtf8CannotEncodeAreReplaced() {
+        context().parse("above: \"\\UFFFFFFFF\\U00110000\"\nsurrogate: \"a\\uD800\\udfffb\"\nlast: \"\\U0010FFFF\"\n");
+        specify(context().valueAs<std::string>("above"), should.equal("\xef\xbf\xbd\xef\xbf\xbd"));
+        specify(context().valueAs<std::string>("surrogate"), should.equal("a\xef\xbf\xbd\xef\xbf\xbd" "b"));
+        specify(context().valueAs<std::string>("last"), should.equal("\xf4\x8f\xbf\xbf"));
+    }
+
+    void escapeFreeQuotedScalarsCostNoMoreThanPlainOnes() {
+        specify(allocations("name: \"averylongvaluewithoutescapes\""), should.equal(allocations("name: averylongvaluewithoutescapes")));
+    }
+
+    void emittedStringsParseBack() {
+        Document document;
+        document.parse("text: \"line\\none: \\\"two\\\"\"");
+        Document parsed;
+        parsed.parse(Emitter().emit(document));
+        specify(parsed.valueAs<std::string>("text"), should.equal("line\none: \"two\""));
+    }
+
+private:
+    static size_t allocations(const std::string& data) {
+        Document document;
+        document.collectStats(true);
+        document.parse(data);
+        return document.stats().allocations;
+    }
+} quotedScalarSpec;
+
+#endif
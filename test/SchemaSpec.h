@@ -0,0 +1,80 @@
+#ifndef SCHEMASPEC_H
+#define SCHEMASPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+
+using CppSpec::Specification;
+
+class SchemaSpec : public Specification<Document, SchemaSpec> {
+public:
+    SchemaSpec() : schema(Schema().require("host", Schema::String).require("port", Schema::Int).range("port", 1, 65535)
+        .allow("mode", Schema::String).oneOf("mode", modes()).allow("tls", Schema::Map).items(Schema::String).compile()) {
+        REGISTER_BEHAVIOUR(SchemaSpec, matchingDocumentIsParsed);
+        REGISTER_BEHAVIOUR(SchemaSpec, wrongTypeIsRejectedWithPosition);
+        REGISTER_BEHAVIOUR(SchemaSpec, valueOutOfRangeIsRejected);
+        REGISTER_BEHAVIOUR(SchemaSpec, valueNotAllowedIsRejected);
+        REGISTER_BEHAVIOUR(SchemaSpec, missingRequiredKeyIsRejected);
+        REGISTER_BEHAVIOUR(SchemaSpec, closedSchemaRejectsUnknownKeys);
+        REGISTER_BEHAVIOUR(SchemaSpec, rejectedDocumentIsLeftEmpty);
+    }
+
+    void matchingDocumentIsParsed() {
+        parse_info<> info = context().parse("host: db\nport: 5432\nmode: fast\ntls: {cert: x}\nextra: 1\n- item", schema);
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<int>("port"), should.equal(5432));
+    }
+
+    void wrongTypeIsRejectedWithPosition() {
+        try {
+            context().parse("host: db\n# the port\nport:  \"5432\"", schema);
+            specify(false, should.equal(true));
+        } catch (const ValidationException& e) {
+            specify(std::string(e.what()), should.equal("Value of 'port' has the wrong type at line 3, column 8."));
+            specify(e.line(), should.equal(3u));
+            specify(e.column(), should.equal(8u));
+        }
+    }
+
+    void valueOutOfRangeIsRejected() {
+        specify(invoking(parse, std::string("host: db\nport: 70000"), schema).should.raise.exception<ValidationException>("Value of 'port' is out of range at line 2, column 7."));
+    }
+
+    void valueNotAllowedIsRejected() {
+        specify(invoking(parse, std::string("mode: slow"), schema).should.raise.exception<ValidationException>("Value of 'mode' is not one of the allowed values at line 1, column 7."));
+    }
+
+    void missingRequiredKeyIsRejected() {
+        specify(invoking(parse, std::string("host: db\n"), schema).should.raise.exception<ValidationException>("Required key 'port' is missing at line 2, column 1."));
+    }
+
+    void closedSchemaRejectsUnknownKeys() {
+        CompiledSchema closed(Schema().allow("host", Schema::String).closed().compile());
+        specify(invoking(parse, std::string("host: db\nhots: db"), closed).should.raise.exception<ValidationException>("Key 'hots' is not allowed at line 2, column 1."));
+    }
+
+    void rejectedDocumentIsLeftEmpty() {
+        try {
+            context().parse("host: db\nport: 0", schema);
+        } catch (const ValidationException&) {
+        }
+        specify(context().begin() == context().end(), should.equal(true));
+    }
+
+private:
+    static std::vector<std::string> modes() {
+        std::vector<std::string> modes;
+        modes.push_back("fast");
+        modes.push_back("safe");
+        return modes;
+    }
+
+    typedef parse_info<> (Document::*Parse)(const std::string&, const CompiledSchema&);
+    static const Parse parse;
+
+    CompiledSchema schema;
+} schemaSpec;
+
+const SchemaSpec::Parse SchemaSpec::parse = &Document::parse;
+
+#endif
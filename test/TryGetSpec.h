@@ -0,0 +1,66 @@
+#ifndef TRYGETSPEC_H
+#define TRYGETSPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+
+using CppSpec::Specification;
+
+class TryGetSpec : public Specification<Document, TryGetSpec> {
+public:
+    TryGetSpec() {
+        REGISTER_BEHAVIOUR(TryGetSpec, presentValueIsReturned);
+        REGISTER_BEHAVIOUR(TryGetSpec, missingKeyGivesNone);
+        REGISTER_BEHAVIOUR(TryGetSpec, wrongTypeGivesNone);
+        REGISTER_BEHAVIOUR(TryGetSpec, aliasesAndMergesAreFollowed);
+        REGISTER_BEHAVIOUR(TryGetSpec, mappingCanBeBorrowed);
+        REGISTER_BEHAVIOUR(TryGetSpec, listItemsCanBeTried);
+        REGISTER_BEHAVIOUR(TryGetSpec, missingListGivesNull);
+    }
+
+    void presentValueIsReturned() {
+        context().parse("host: example\nport: 8080");
+        specify(context().tryGet<std::string>("host").value(), should.equal("example"));
+        specify(context().tryGet<int>("port").value(), should.equal(8080));
+    }
+
+    void missingKeyGivesNone() {
+        context().parse("host: example");
+        specify(context().tryGet<int>("port").is_initialized(), should.equal(false));
+        specify(context().tryGet<int>("port").value_or(80), should.equal(80));
+        specify(context().find("port") == 0, should.equal(true));
+    }
+
+    void wrongTypeGivesNone() {
+        context().parse("host: example");
+        specify(context().tryGet<int>("host").is_initialized(), should.equal(false));
+    }
+
+    void aliasesAndMergesAreFollowed() {
+        context().parse("base: &base {port: 22}\nname: &name server\ncopy: *name\n<<: *base");
+        specify(context().tryGet<std::string>("copy").value(), should.equal("server"));
+        specify(context().tryGet<int>("port").value(), should.equal(22));
+    }
+
+    void mappingCanBeBorrowed() {
+        context().parse("server: {host: example, port: 22}");
+        boost::optional<const Mapping&> server = context().tryGet<const Mapping&>("server");
+        specify(&server.value() == &context().valueAs<const Mapping&>("server"), should.equal(true));
+        specify(server->tryGet<int>("port").value(), should.equal(22));
+        specify(server->tryGet<int>("user").is_initialized(), should.equal(false));
+    }
+
+    void listItemsCanBeTried() {
+        context().parse("- 1\n- two");
+        const List& items = *context().findList();
+        specify(items.tryGet<std::string>(1).value(), should.equal("two"));
+        specify(items.tryGet<std::string>(2).is_initialized(), should.equal(false));
+    }
+
+    void missingListGivesNull() {
+        context().parse("host: example");
+        specify(context().findList() == 0, should.equal(true));
+    }
+} tryGetSpec;
+
+#endif
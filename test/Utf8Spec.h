@@ -0,0 +1,49 @@
+#ifndef UTF8SPEC_H
+#define UTF8SPEC_H
+
+#include <CppSpec/CppSpec.h>
+#include "yamlpp/Document.h"
+
+using CppSpec::Specification;
+
+class Utf8Spec : public Specification<Document, Utf8Spec> {
+public:
+    Utf8Spec() {
+        REGISTER_BEHAVIOUR(Utf8Spec, canParseNonAsciiScalars);
+        REGISTER_BEHAVIOUR(Utf8Spec, invalidUtf8FailsBeforeAnythingIsParsed);
+        REGISTER_BEHAVIOUR(Utf8Spec, malformedSequencesAreRejected);
+    }
+
+    void canParseNonAsciiScalars() {
+        parse_info<> info = context().parse("joukkue:\xc3\x84ss\xc3\xa4t\nkaupunki:Pori\n- Lukko\n- \xc3\x84ss\xc3\xa4t");
+        specify(info.full, should.equal(true));
+        specify(context().valueAs<std::string>("joukkue"), should.equal("\xc3\x84ss\xc3\xa4t"));
+        specify(context().list().valueAs<std::string>(1), should.equal("\xc3\x84ss\xc3\xa4t"));
+    }
+
+    void invalidUtf8FailsBeforeAnythingIsParsed() {
+        std::string data("foo:bar\nbaz:\xc3\x28");
+        parse_info<> info = context().parse(data);
+        specify(info.hit, should.equal(false));
+        specify(info.stop - data.c_str(), should.equal(12));
+        specify(context().begin() == context().end(), should.equal(true));
+    }
+
+    void malformedSequencesAreRejected() {
+        specify(isValid("\xf0\x9f\x98\x80 \xe2\x82\xac \xc3\xa4"), should.equal(true));
+        specify(isValid("\xc0\xaf"), should.equal(false));
+        specify(isValid("\xe0\x80\xaf"), should.equal(false));
+        specify(isValid("\xed\xa0\x80"), should.equal(false));
+        specify(isValid("\xf4\x90\x80\x80"), should.equal(false));
+        specify(isValid("\xe2\x82"), should.equal(false));
+        specify(isValid("\x80"), should.equal(false));
+        specify(isValid(std::string(40, 'a') + "\xff" + std::string(40, 'a')), should.equal(false));
+    }
+
+private:
+    static bool isValid(const std::string& data) {
+        return validateUtf8(data.data(), data.data() + data.size()) == data.data() + data.size();
+    }
+} utf8Spec;
+
+#endif
@@ -1,4 +1,29 @@
+#define YAMLPP_COUNT_ALLOCATIONS
 #include <CppSpec/CppSpec.h>
 #include "ParserSpec.h"
+#include "EmitterSpec.h"
+#include "JsonTranscoderSpec.h"
+#include "BinarySpec.h"
+#include "ParseStatsSpec.h"
+#include "MoveSpec.h"
+#include "DocumentPoolSpec.h"
+#include "Utf8Spec.h"
+#include "QuotedScalarSpec.h"
+#include "BlockScalarSpec.h"
+#include "CommentSpec.h"
+#include "AnchorSpec.h"
+#include "MergeKeySpec.h"
+#include "SchemaSpec.h"
+#include "ParseErrorSpec.h"
+#include "TryGetSpec.h"
+#include "ParseLimitsSpec.h"
+#include "CancellationSpec.h"
+#include "AsyncParseSpec.h"
+#include "FileLoaderSpec.h"
+#include "ExecutorSpec.h"
+#include "ParallelParserSpec.h"
+#include "CompressedSpec.h"
+#include "DiffSpec.h"
+#include "PatchSpec.h"
 
 CPPSPEC_MAIN
@@ -0,0 +1,195 @@
+#ifndef YAMLPP_ASYNCPARSE_H
+#define YAMLPP_ASYNCPARSE_H
+
+#include "PushParser.h"
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif
+
+// Bytes that arrive over time, such as from a socket or a pipe.
+class AsyncByteSource {
+public:
+    virtual ~AsyncByteSource() {}
+
+    // Copies up to size available bytes into buffer without waiting for
+    // more. Returns the number copied, 0 at the end of the input, or -1 if
+    // no bytes are available yet.
+    virtual std::ptrdiff_t read(char* buffer, size_t size) = 0;
+};
+
+// Reads from a file descriptor, which must be non-blocking.
+class FdByteSource : public AsyncByteSource {
+public:
+    explicit FdByteSource(int fd) : fd(fd) {}
+
+    std::ptrdiff_t read(char* buffer, size_t size) {
+        for (;;) {
+            ssize_t count = ::read(fd, buffer, size);
+            if (count >= 0) {
+                return count;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return -1;
+            }
+            if (errno != EINTR) {
+                raiseError(std::runtime_error(std::string("Cannot read input: ") + std::strerror(errno)));
+            }
+        }
+    }
+
+private:
+    int fd;
+};
+
+// A parse that goes on as its source has bytes, for event loops that serve
+// many inputs from a few threads. The loop calls resume() whenever the
+// source may have more bytes; resume() parses at most one chunk of what is
+// there and returns without waiting for the rest, so that the sources of a
+// loop take turns. A parse in progress holds only its unfinished top level
+// block and a read buffer.
+//
+//   AsyncParse parse(source, document);
+//   ... when fd is readable:
+//   if (parse.resume()) {
+//       done, parse.ok() tells whether the document is complete
+//   }
+class AsyncParse {
+public:
+    AsyncParse(AsyncByteSource& source, Document& document, size_t chunk = 64 * 1024)
+    : source(source), parser(document), chunk(chunk), buffer(), finished(false), parsed(false) {}
+
+    // Parses up to a chunk of the bytes available. Returns true once the
+    // parse is over, either at the end of the input or at the first error,
+    // and false while more input is awaited.
+    bool resume() {
+        if (finished) {
+            return true;
+        }
+        if (buffer.empty()) {
+            buffer.resize(chunk);
+        }
+        std::ptrdiff_t count = source.read(&buffer[0], buffer.size());
+        if (count < 0) {
+            return false;
+        }
+        if (count == 0) {
+            parsed = parser.finish();
+        } else if (parser.feed(&buffer[0], count)) {
+            return false;
+        } else {
+            parser.finish();
+        }
+        finished = true;
+        std::vector<char>().swap(buffer);
+        return true;
+    }
+
+    bool done() const {return finished;}
+
+    // True when the parse is over and the whole input was parsed.
+    bool ok() const {return finished && parsed;}
+
+    const ParseError& error() const {return parser.error();}
+
+private:
+    AsyncParse(const AsyncParse&);
+    AsyncParse& operator=(const AsyncParse&);
+
+private:
+    AsyncByteSource& source;
+    PushParser parser;
+    size_t chunk;
+    std::vector<char> buffer;
+    bool finished;
+    bool parsed;
+};
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+// The coroutine that parseAsync() runs. The loop drives it the way it
+// drives an AsyncParse: resume() whenever the source may have more bytes,
+// until it returns true. Errors are in the document's error().
+class AsyncParseTask {
+public:
+    struct promise_type {
+        bool parsed = false;
+        std::exception_ptr exception;
+
+        AsyncParseTask get_return_object() {
+            return AsyncParseTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept {return {};}
+        std::suspend_always final_suspend() noexcept {return {};}
+        void return_value(bool result) {parsed = result;}
+        void unhandled_exception() {exception = std::current_exception();}
+    };
+
+    AsyncParseTask(AsyncParseTask&& other) noexcept : handle(other.handle) {other.handle = nullptr;}
+
+    ~AsyncParseTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    // Parses up to a chunk of the bytes available. Returns true once the
+    // parse is over and false while more input is awaited. Exceptions of
+    // the parse, such as exceeded limits, are thrown from here.
+    bool resume() {
+        if (!handle.done()) {
+            handle.resume();
+        }
+        if (handle.promise().exception) {
+            std::exception_ptr exception(handle.promise().exception);
+            handle.promise().exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+        return handle.done();
+    }
+
+    bool done() const {return handle.done();}
+
+    // True when the parse is over and the whole input was parsed.
+    bool ok() const {return handle.done() && handle.promise().parsed;}
+
+private:
+    explicit AsyncParseTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    AsyncParseTask(const AsyncParseTask&) = delete;
+    AsyncParseTask& operator=(const AsyncParseTask&) = delete;
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Parses source into document as a coroutine, suspending whenever the
+// source has no bytes yet and after every chunk.
+//
+//   AsyncParseTask parse(parseAsync(source, document));
+//   ... when fd is readable:
+//   if (parse.resume()) {
+//       done, parse.ok() tells whether the document is complete
+//   }
+inline AsyncParseTask parseAsync(AsyncByteSource& source, Document& document, size_t chunk = 64 * 1024) {
+    PushParser parser(document);
+    std::vector<char> buffer(chunk);
+    for (;;) {
+        std::ptrdiff_t count = source.read(&buffer[0], buffer.size());
+        if (count == 0) {
+            co_return parser.finish();
+        }
+        if (count > 0 && !parser.feed(&buffer[0], count)) {
+            parser.finish();
+            co_return false;
+        }
+        co_await std::suspend_always();
+    }
+}
+
+#endif
+
+#endif
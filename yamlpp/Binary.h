@@ -0,0 +1,454 @@
+#ifndef YAMLPP_BINARY_H
+#define YAMLPP_BINARY_H
+
+#include "Document.h"
+#include <boost/cstdint.hpp>
+#include <climits>
+
+class DecodeException : public std::runtime_error {
+public:
+    explicit DecodeException(const std::string& reason)
+    : std::runtime_error("Cannot decode document: " + reason + ".") {}
+};
+
+// Bounds checked big endian reader over an encoded buffer.
+class BinaryReader {
+public:
+    BinaryReader(const char* first, const char* last) : p(first), last(last) {}
+
+    bool atEnd() const {return p == last;}
+
+    unsigned char byte() {
+        need(1);
+        return static_cast<unsigned char>(*p++);
+    }
+
+    boost::uint64_t big(size_t bytes) {
+        need(bytes);
+        boost::uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value = (value << 8) | static_cast<unsigned char>(*p++);
+        }
+        return value;
+    }
+
+    std::string string(boost::uint64_t length) {
+        need(length);
+        std::string value(p, static_cast<size_t>(length));
+        p += length;
+        return value;
+    }
+
+private:
+    void need(boost::uint64_t bytes) const {
+        if (static_cast<boost::uint64_t>(last - p) < bytes) {
+            raiseError(DecodeException("unexpected end of data"));
+        }
+    }
+
+private:
+    const char* p;
+    const char* last;
+};
+
+// Helpers shared by the binary encodings. Both write at most nine bytes of
+// framing per value, which is what the output buffer is reserved for, and
+// decode into a map of their own that replaces the document's content only
+// once all of the data has been read, so corrupt data leaves the document
+// as it was.
+class BinaryCodec {
+protected:
+    static void writeBig(boost::uint64_t value, size_t bytes, std::string& out) {
+        for (size_t i = bytes; i-- > 0;) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    static size_t estimate(const boost::any& item) {
+        const boost::any& value = resolve(item);
+        if (value.type() == typeid(std::string)) {
+            return boost::any_cast<const std::string&>(value).size() + 9;
+        }
+        if (value.type() == typeid(List)) {
+            const List& list = boost::any_cast<const List&>(value);
+            size_t size = 9;
+            for (size_t i = 0; i < list.count(); i++) {
+                size += estimate(list[i]);
+            }
+            return size;
+        }
+        if (value.type() == typeid(Mapping)) {
+            size_t size = 9;
+            boost::any_cast<const Mapping&>(value).forEach([&size](const std::string& key, const boost::any& entry) {
+                size += key.size() + 9 + estimate(entry);
+            });
+            return size;
+        }
+        return 9;
+    }
+
+    // Mappings are written with their merged entries, as the emitter
+    // writes them, and come back with those as their own.
+    static size_t entries(const Mapping& mapping) {
+        size_t count = 0;
+        mapping.forEach([&count](const std::string&, const boost::any&) {count++;});
+        return count;
+    }
+
+    // Nesting deeper than flow mappings may have is treated as corrupt
+    // data, so that decoding cannot exhaust the stack.
+    static void nest(size_t depth) {
+        if (depth > flowMappingDepthLimit) {
+            raiseError(DecodeException("items nested too deeply"));
+        }
+    }
+
+    static size_t estimate(const Document& document, size_t& count) {
+        size_t size = 9;
+        count = 0;
+        for (Document::const_iterator it = document.begin(); it != document.end(); it++) {
+            if (!it->second.empty()) {
+                size += it->first.size() + 9 + estimate(it->second);
+                count++;
+            }
+        }
+        return size;
+    }
+
+    static int toInt(boost::int64_t value) {
+        if (value < INT_MIN || value > INT_MAX) {
+            raiseError(DecodeException("integer out of range"));
+        }
+        return static_cast<int>(value);
+    }
+
+    static const std::string& text(const boost::any& value) {
+        return boost::any_cast<const std::string&>(value);
+    }
+};
+
+class Cbor : private BinaryCodec {
+public:
+    static std::string encode(const Document& document) {
+        std::string out;
+        size_t count;
+        out.reserve(estimate(document, count));
+        writeHead(Map, count, out);
+        for (Document::const_iterator it = document.begin(); it != document.end(); it++) {
+            if (!it->second.empty()) {
+                writeHead(Text, it->first.size(), out);
+                out.append(it->first);
+                writeValue(it->second, out);
+            }
+        }
+        return out;
+    }
+
+    static void decode(const std::string& data, Document& document) {
+        BinaryReader in(data.data(), data.data() + data.size());
+        unsigned char initial = in.byte();
+        if (initial >> 5 != Map) {
+            raiseError(DecodeException("top level item is not a map"));
+        }
+        std::map<std::string, boost::any> values;
+        for (boost::uint64_t count = argument(in, initial); count > 0; count--) {
+            boost::any key(readScalar(in, in.byte()));
+            if (key.type() != typeid(std::string)) {
+                raiseError(DecodeException("map key is not a string"));
+            }
+            readInto(values[text(key)], in);
+        }
+        if (!in.atEnd()) {
+            raiseError(DecodeException("trailing data"));
+        }
+        document.reset();
+        document.values.swap(values);
+    }
+
+private:
+    enum Major {Unsigned = 0, Negative = 1, Text = 3, Array = 4, Map = 5};
+
+    static void writeHead(Major major, boost::uint64_t value, std::string& out) {
+        char type = static_cast<char>(major << 5);
+        if (value < 24) {
+            out.push_back(type | static_cast<char>(value));
+        } else if (value <= 0xff) {
+            out.push_back(type | 24);
+            writeBig(value, 1, out);
+        } else if (value <= 0xffff) {
+            out.push_back(type | 25);
+            writeBig(value, 2, out);
+        } else if (value <= 0xffffffffULL) {
+            out.push_back(type | 26);
+            writeBig(value, 4, out);
+        } else {
+            out.push_back(type | 27);
+            writeBig(value, 8, out);
+        }
+    }
+
+    static void writeValue(const boost::any& item, std::string& out) {
+        const boost::any& value = resolve(item);
+        if (value.type() == typeid(int)) {
+            boost::int64_t number = boost::any_cast<int>(value);
+            if (number < 0) {
+                writeHead(Negative, static_cast<boost::uint64_t>(-1 - number), out);
+            } else {
+                writeHead(Unsigned, static_cast<boost::uint64_t>(number), out);
+            }
+        } else if (value.type() == typeid(std::string)) {
+            writeHead(Text, text(value).size(), out);
+            out.append(text(value));
+        } else if (value.type() == typeid(List)) {
+            const List& list = boost::any_cast<const List&>(value);
+            writeHead(Array, list.count(), out);
+            for (size_t i = 0; i < list.count(); i++) {
+                writeValue(list[i], out);
+            }
+        } else if (value.type() == typeid(Mapping)) {
+            const Mapping& mapping = boost::any_cast<const Mapping&>(value);
+            writeHead(Map, entries(mapping), out);
+            mapping.forEach([&out](const std::string& key, const boost::any& entry) {
+                writeHead(Text, key.size(), out);
+                out.append(key);
+                writeValue(entry, out);
+            });
+        } else {
+            raiseError(std::runtime_error(std::string("Cannot encode value of type ") + value.type().name()));
+        }
+    }
+
+    static boost::uint64_t argument(BinaryReader& in, unsigned char initial) {
+        unsigned char info = initial & 0x1f;
+        if (info < 24) {
+            return info;
+        }
+        if (info > 27) {
+            raiseError(DecodeException("indefinite lengths are not supported"));
+        }
+        return in.big(size_t(1) << (info - 24));
+    }
+
+    // Lists and mappings are decoded in place into the map node so that
+    // they are never copied through a boost::any.
+    static void readInto(boost::any& node, BinaryReader& in, size_t depth = 1) {
+        unsigned char initial = in.byte();
+        if (initial >> 5 == Array) {
+            nest(depth);
+            node = List();
+            List& list = boost::any_cast<List&>(node);
+            for (boost::uint64_t count = argument(in, initial); count > 0; count--) {
+                readInto(list.append(), in, depth + 1);
+            }
+        } else if (initial >> 5 == Map) {
+            nest(depth);
+            node = Mapping();
+            Mapping& mapping = boost::any_cast<Mapping&>(node);
+            for (boost::uint64_t count = argument(in, initial); count > 0; count--) {
+                boost::any key(readScalar(in, in.byte()));
+                if (key.type() != typeid(std::string)) {
+                    raiseError(DecodeException("map key is not a string"));
+                }
+                readInto(mapping[text(key)], in, depth + 1);
+            }
+        } else {
+            node = readScalar(in, initial);
+        }
+    }
+
+    static boost::any readScalar(BinaryReader& in, unsigned char initial) {
+        boost::uint64_t value = argument(in, initial);
+        switch (initial >> 5) {
+        case Unsigned:
+            if (value > INT_MAX) {
+                raiseError(DecodeException("integer out of range"));
+            }
+            return boost::any(static_cast<int>(value));
+        case Negative:
+            if (value > INT_MAX) {
+                raiseError(DecodeException("integer out of range"));
+            }
+            return boost::any(-1 - static_cast<int>(value));
+        case Text:
+            return boost::any(in.string(value));
+        default:
+            raiseError(DecodeException("unsupported item type"));
+        }
+    }
+};
+
+class MessagePack : private BinaryCodec {
+public:
+    static std::string encode(const Document& document) {
+        std::string out;
+        size_t count;
+        out.reserve(estimate(document, count));
+        writeHead(count, 0x80, 16, 0xde, out);
+        for (Document::const_iterator it = document.begin(); it != document.end(); it++) {
+            if (!it->second.empty()) {
+                writeString(it->first, out);
+                writeValue(it->second, out);
+            }
+        }
+        return out;
+    }
+
+    static void decode(const std::string& data, Document& document) {
+        BinaryReader in(data.data(), data.data() + data.size());
+        unsigned char type = in.byte();
+        boost::uint64_t count;
+        if (type >= 0x80 && type <= 0x8f) {
+            count = type & 0x0f;
+        } else if (type == 0xde || type == 0xdf) {
+            count = in.big(type == 0xde ? 2 : 4);
+        } else {
+            raiseError(DecodeException("top level item is not a map"));
+        }
+        std::map<std::string, boost::any> values;
+        for (; count > 0; count--) {
+            boost::any key(readScalar(in, in.byte()));
+            if (key.type() != typeid(std::string)) {
+                raiseError(DecodeException("map key is not a string"));
+            }
+            readInto(values[text(key)], in);
+        }
+        if (!in.atEnd()) {
+            raiseError(DecodeException("trailing data"));
+        }
+        document.reset();
+        document.values.swap(values);
+    }
+
+private:
+    // Writes a fix-sized header when count fits in it, otherwise the 16 or
+    // 32 bit variant whose type bytes follow each other.
+    static void writeHead(boost::uint64_t count, unsigned char fix, boost::uint64_t fixLimit, unsigned char type16, std::string& out) {
+        if (count < fixLimit) {
+            out.push_back(static_cast<char>(fix | count));
+        } else if (count <= 0xffff) {
+            out.push_back(static_cast<char>(type16));
+            writeBig(count, 2, out);
+        } else {
+            out.push_back(static_cast<char>(type16 + 1));
+            writeBig(count, 4, out);
+        }
+    }
+
+    static void writeString(const std::string& value, std::string& out) {
+        if (value.size() >= 32 && value.size() <= 0xff) {
+            out.push_back(static_cast<char>(0xd9));
+            writeBig(value.size(), 1, out);
+        } else {
+            writeHead(value.size(), 0xa0, 32, 0xda, out);
+        }
+        out.append(value);
+    }
+
+    static void writeInt(int value, std::string& out) {
+        if (value >= -32 && value <= 127) {
+            out.push_back(static_cast<char>(value));
+        } else if (value > 0) {
+            int bytes = value <= 0xff ? 1 : value <= 0xffff ? 2 : 4;
+            out.push_back(static_cast<char>(bytes == 1 ? 0xcc : bytes == 2 ? 0xcd : 0xce));
+            writeBig(static_cast<boost::uint64_t>(value), bytes, out);
+        } else {
+            int bytes = value >= SCHAR_MIN ? 1 : value >= SHRT_MIN ? 2 : 4;
+            out.push_back(static_cast<char>(bytes == 1 ? 0xd0 : bytes == 2 ? 0xd1 : 0xd2));
+            writeBig(static_cast<boost::uint64_t>(static_cast<boost::int64_t>(value)), bytes, out);
+        }
+    }
+
+    static void writeValue(const boost::any& item, std::string& out) {
+        const boost::any& value = resolve(item);
+        if (value.type() == typeid(int)) {
+            writeInt(boost::any_cast<int>(value), out);
+        } else if (value.type() == typeid(std::string)) {
+            writeString(text(value), out);
+        } else if (value.type() == typeid(List)) {
+            const List& list = boost::any_cast<const List&>(value);
+            writeHead(list.count(), 0x90, 16, 0xdc, out);
+            for (size_t i = 0; i < list.count(); i++) {
+                writeValue(list[i], out);
+            }
+        } else if (value.type() == typeid(Mapping)) {
+            const Mapping& mapping = boost::any_cast<const Mapping&>(value);
+            writeHead(entries(mapping), 0x80, 16, 0xde, out);
+            mapping.forEach([&out](const std::string& key, const boost::any& entry) {
+                writeString(key, out);
+                writeValue(entry, out);
+            });
+        } else {
+            raiseError(std::runtime_error(std::string("Cannot encode value of type ") + value.type().name()));
+        }
+    }
+
+    static void readInto(boost::any& node, BinaryReader& in, size_t depth = 1) {
+        unsigned char type = in.byte();
+        boost::uint64_t count;
+        if (type >= 0x90 && type <= 0x9f) {
+            count = type & 0x0f;
+        } else if (type == 0xdc || type == 0xdd) {
+            count = in.big(type == 0xdc ? 2 : 4);
+        } else if (type >= 0x80 && type <= 0x8f) {
+            readMapping(node, in, type & 0x0f, depth);
+            return;
+        } else if (type == 0xde || type == 0xdf) {
+            readMapping(node, in, in.big(type == 0xde ? 2 : 4), depth);
+            return;
+        } else {
+            node = readScalar(in, type);
+            return;
+        }
+        nest(depth);
+        node = List();
+        List& list = boost::any_cast<List&>(node);
+        for (; count > 0; count--) {
+            readInto(list.append(), in, depth + 1);
+        }
+    }
+
+    static void readMapping(boost::any& node, BinaryReader& in, boost::uint64_t count, size_t depth) {
+        nest(depth);
+        node = Mapping();
+        Mapping& mapping = boost::any_cast<Mapping&>(node);
+        for (; count > 0; count--) {
+            boost::any key(readScalar(in, in.byte()));
+            if (key.type() != typeid(std::string)) {
+                raiseError(DecodeException("map key is not a string"));
+            }
+            readInto(mapping[text(key)], in, depth + 1);
+        }
+    }
+
+    static boost::any readScalar(BinaryReader& in, unsigned char type) {
+        if (type <= 0x7f || type >= 0xe0) {
+            return boost::any(static_cast<int>(static_cast<signed char>(type)));
+        }
+        if (type >= 0xa0 && type <= 0xbf) {
+            return boost::any(in.string(type & 0x1f));
+        }
+        switch (type) {
+        case 0xcc: case 0xcd: case 0xce: case 0xcf: {
+            boost::uint64_t value = in.big(size_t(1) << (type - 0xcc));
+            if (value > INT_MAX) {
+                raiseError(DecodeException("integer out of range"));
+            }
+            return boost::any(static_cast<int>(value));
+        }
+        case 0xd0: case 0xd1: case 0xd2: case 0xd3: {
+            size_t bytes = size_t(1) << (type - 0xd0);
+            boost::uint64_t value = in.big(bytes);
+            if (bytes < 8 && (value >> (8 * bytes - 1))) {
+                value |= ~boost::uint64_t(0) << (8 * bytes);
+            }
+            return boost::any(toInt(static_cast<boost::int64_t>(value)));
+        }
+        case 0xd9: case 0xda: case 0xdb:
+            return boost::any(in.string(in.big(size_t(1) << (type - 0xd9))));
+        default:
+            raiseError(DecodeException("unsupported item type"));
+        }
+    }
+};
+
+#endif
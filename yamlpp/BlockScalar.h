@@ -0,0 +1,176 @@
+#ifndef YAMLPP_BLOCKSCALAR_H
+#define YAMLPP_BLOCKSCALAR_H
+
+#include <boost/spirit.hpp>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+// Header line of a literal (|) or folded (>) block scalar.
+struct BlockHeader {
+    BlockHeader() : style(0), chomping(0), indent(0), body(0) {}
+
+    char style;
+    char chomping;
+    size_t indent;
+    const char* body;
+};
+
+inline const char* findLineEnd(const char* p, const char* last) {
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', last - p));
+    return newline ? newline : last;
+}
+
+inline const char* skipSpaces(const char* p, const char* last) {
+    while (p != last && *p == ' ') {
+        p++;
+    }
+    return p;
+}
+
+// Reads the header starting at the indicator. Returns false if the line is
+// not a block scalar header.
+inline bool parseBlockHeader(const char* first, const char* last, BlockHeader& header) {
+    if (first == last || (*first != '|' && *first != '>')) {
+        return false;
+    }
+    header = BlockHeader();
+    header.style = *first;
+    const char* p = first + 1;
+    for (int i = 0; i < 2 && p != last; i++, p++) {
+        if ((*p == '-' || *p == '+') && !header.chomping) {
+            header.chomping = *p;
+        } else if (*p >= '1' && *p <= '9' && !header.indent) {
+            header.indent = *p - '0';
+        } else {
+            break;
+        }
+    }
+    const char* text = skipSpaces(p, last);
+    if (text != last && *text != '\n' && (*text != '#' || text == p)) {
+        return false;
+    }
+    const char* end = findLineEnd(text, last);
+    header.body = end == last ? last : end + 1;
+    return true;
+}
+
+// Indentation of the block's content: explicit in the header, otherwise
+// that of the first line that is not blank.
+inline size_t blockIndent(const BlockHeader& header, const char* last) {
+    if (header.indent) {
+        return header.indent;
+    }
+    for (const char* line = header.body; line != last;) {
+        const char* text = skipSpaces(line, last);
+        const char* end = findLineEnd(line, last);
+        if (text != end) {
+            return text - line;
+        }
+        line = end == last ? last : end + 1;
+    }
+    return 0;
+}
+
+// Returns the end of the block scalar whose indicator is at first, or 0 if
+// there is none. The block takes every following line that is blank or
+// indented at least as deep as its content; the line break ending its last
+// line is left out. Lines are found with memchr, so the cost is linear in
+// the size of the block.
+inline const char* findBlockEnd(const char* first, const char* last) {
+    BlockHeader header;
+    if (!parseBlockHeader(first, last, header)) {
+        return 0;
+    }
+    const char* end = findLineEnd(first, last);
+    size_t indent = blockIndent(header, last);
+    if (indent == 0) {
+        return end;
+    }
+    for (const char* line = header.body; line != last;) {
+        const char* text = skipSpaces(line, last);
+        const char* next = findLineEnd(line, last);
+        if (text != next && static_cast<size_t>(text - line) < indent) {
+            break;
+        }
+        end = next;
+        line = next == last ? last : next + 1;
+    }
+    return end;
+}
+
+// Appends the content of the block scalar [first, last) as matched by
+// findBlockEnd. Literal blocks keep their line breaks; folded blocks join
+// lines with spaces except around blank and more indented lines. Lines are
+// copied whole into out.
+inline void decodeBlockScalar(const char* first, const char* last, std::string& out) {
+    BlockHeader header;
+    if (!parseBlockHeader(first, last, header)) {
+        return;
+    }
+    size_t indent = blockIndent(header, last);
+    out.reserve(out.size() + (last - header.body));
+    bool content = false;
+    bool previousNormal = false;
+    size_t blanks = 0;
+    // A trailing blank line is empty, so it starts right at last.
+    for (const char* line = header.body; indent && line <= last;) {
+        const char* end = findLineEnd(line, last);
+        const char* text = line + std::min(indent, static_cast<size_t>(end - line));
+        if (skipSpaces(line, end) == end) {
+            blanks++;
+        } else {
+            bool moreIndented = *text == ' ' || *text == '\t';
+            if (content) {
+                if (header.style == '>' && previousNormal && !moreIndented) {
+                    out.append(blanks ? blanks : 1, blanks ? '\n' : ' ');
+                } else {
+                    out.append(blanks + 1, '\n');
+                }
+            } else {
+                out.append(blanks, '\n');
+            }
+            out.append(text, end);
+            content = true;
+            previousNormal = !moreIndented;
+            blanks = 0;
+        }
+        if (end == last) {
+            break;
+        }
+        line = end + 1;
+    }
+    if (header.chomping == '-' || !content) {
+        if (header.chomping == '+') {
+            out.append(blanks, '\n');
+        }
+        return;
+    }
+    out.push_back('\n');
+    if (header.chomping == '+') {
+        out.append(blanks, '\n');
+    }
+}
+
+inline bool isBlockScalar(const char* first, const char* last) {
+    return first != last && (*first == '|' || *first == '>');
+}
+
+// Spirit parser for a block scalar, from its indicator to the end of its
+// last line. Like all functor parsers it advances the scanner itself.
+struct BlockScalar {
+    typedef boost::spirit::nil_t result_t;
+
+    template<class ScannerT>
+    std::ptrdiff_t operator()(const ScannerT& scan, result_t&) const {
+        const char* first = scan.first;
+        const char* end = findBlockEnd(first, scan.last);
+        if (!end) {
+            return -1;
+        }
+        scan.first = end;
+        return end - first;
+    }
+};
+
+#endif
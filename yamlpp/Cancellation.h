@@ -0,0 +1,35 @@
+#ifndef YAMLPP_CANCELLATION_H
+#define YAMLPP_CANCELLATION_H
+
+#include <boost/function.hpp>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+// Lets another thread stop a parse. The parse checks the token as it
+// reaches the next top level key or list item, so it stops soon after
+// cancel() without the check costing anything in between.
+class CancellationToken {
+public:
+    CancellationToken() : flag(false) {}
+
+    void cancel() {flag.store(true, std::memory_order_relaxed);}
+    bool cancelled() const {return flag.load(std::memory_order_relaxed);}
+
+private:
+    CancellationToken(const CancellationToken&);
+    CancellationToken& operator=(const CancellationToken&);
+
+private:
+    std::atomic<bool> flag;
+};
+
+// Receives the number of bytes parsed so far.
+typedef boost::function1<void, size_t> progress_cb;
+
+class ParseCancelledException : public std::runtime_error {
+public:
+    ParseCancelledException() : std::runtime_error("Parse was cancelled.") {}
+};
+
+#endif
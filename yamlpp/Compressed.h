@@ -0,0 +1,282 @@
+#ifndef YAMLPP_COMPRESSED_H
+#define YAMLPP_COMPRESSED_H
+
+#include "PushParser.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <zlib.h>
+
+// Inflates gzip or zlib data, from memory or read from a file descriptor,
+// a buffer at a time. Concatenated gzip members are read as one input.
+class GzipSource {
+public:
+    static const size_t defaultBuffer = 64 * 1024;
+
+    explicit GzipSource(int fd, size_t buffer = defaultBuffer)
+    : fd(fd), input(buffer), memory(0), memory_left(0), stream(), input_done(false), stream_ended(false) {
+        init();
+    }
+
+    GzipSource(const char* data, size_t size)
+    : fd(-1), input(), memory(data), memory_left(size), stream(), input_done(true), stream_ended(false) {
+        init();
+    }
+
+    ~GzipSource() {
+        inflateEnd(&stream);
+    }
+
+    // Inflates up to size bytes into buffer. Returns the number of bytes
+    // inflated, which is less than size only at the end of the input, where
+    // it is 0.
+    size_t read(char* buffer, size_t size) {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = static_cast<uInt>(size);
+        while (stream.avail_out) {
+            if (!stream.avail_in && !refill()) {
+                if (!stream_ended) {
+                    raiseError(std::runtime_error("Compressed input is truncated"));
+                }
+                break;
+            }
+            if (stream_ended) {
+                inflateReset(&stream);
+                stream_ended = false;
+            }
+            int result = inflate(&stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END) {
+                stream_ended = true;
+            } else if (result != Z_OK) {
+                raiseError(std::runtime_error(std::string("Compressed input is corrupt: ") + (stream.msg ? stream.msg : zError(result))));
+            }
+        }
+        return size - stream.avail_out;
+    }
+
+private:
+    void init() {
+        if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+            raiseError(std::bad_alloc());
+        }
+    }
+
+    // Reads more compressed input. Returns false at its end. Input in
+    // memory is handed to zlib in slices its counts can hold.
+    bool refill() {
+        if (memory_left) {
+            size_t slice = std::min<size_t>(memory_left, std::numeric_limits<uInt>::max());
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(memory));
+            stream.avail_in = static_cast<uInt>(slice);
+            memory += slice;
+            memory_left -= slice;
+            return true;
+        }
+        while (!input_done) {
+            ssize_t count = ::read(fd, &input[0], input.size());
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                raiseError(std::runtime_error(std::string("Cannot read input: ") + std::strerror(errno)));
+            }
+            if (count == 0) {
+                input_done = true;
+                break;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(&input[0]);
+            stream.avail_in = static_cast<uInt>(count);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    GzipSource(const GzipSource&);
+    GzipSource& operator=(const GzipSource&);
+
+private:
+    int fd;
+    std::vector<char> input;
+    const char* memory;
+    size_t memory_left;
+    z_stream stream;
+    bool input_done;
+    bool stream_ended;
+};
+
+// Chunks of inflated input handed from the inflating thread to the parsing
+// one. A fixed set of buffers goes round between them, so neither allocates
+// and at most that many chunks are held at a time.
+class ChunkQueue {
+public:
+    struct Chunk {
+        std::vector<char> data;
+        size_t size;
+    };
+
+    ChunkQueue(size_t size, size_t count) : chunks(count), free(), filled(), lock(), changed(), closed(false), finished(false) {
+        for (size_t i = 0; i < chunks.size(); i++) {
+            chunks[i].data.resize(size);
+            free.push_back(&chunks[i]);
+        }
+    }
+
+    // Returns a chunk to fill, waiting for one to be free, or null once the
+    // queue has been closed.
+    Chunk* take() {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this] {return closed || !free.empty();});
+        return pop(free);
+    }
+
+    void put(Chunk* chunk) {
+        push(filled, chunk);
+    }
+
+    // Marks the end of the chunks put.
+    void finish() {
+        std::lock_guard<std::mutex> guard(lock);
+        finished = true;
+        changed.notify_all();
+    }
+
+    // Returns the next filled chunk, waiting for one, or null after the
+    // last.
+    Chunk* next() {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this] {return finished || !filled.empty();});
+        return pop(filled);
+    }
+
+    void recycle(Chunk* chunk) {
+        push(free, chunk);
+    }
+
+    // Stops handing out chunks to fill, for when the rest of the input is
+    // no longer wanted.
+    void close() {
+        std::lock_guard<std::mutex> guard(lock);
+        closed = true;
+        changed.notify_all();
+    }
+
+private:
+    static Chunk* pop(std::deque<Chunk*>& chunks) {
+        if (chunks.empty()) {
+            return 0;
+        }
+        Chunk* chunk = chunks.front();
+        chunks.pop_front();
+        return chunk;
+    }
+
+    void push(std::deque<Chunk*>& chunks, Chunk* chunk) {
+        std::lock_guard<std::mutex> guard(lock);
+        chunks.push_back(chunk);
+        changed.notify_all();
+    }
+
+private:
+    ChunkQueue(const ChunkQueue&);
+    ChunkQueue& operator=(const ChunkQueue&);
+
+private:
+    std::vector<Chunk> chunks;
+    std::deque<Chunk*> free;
+    std::deque<Chunk*> filled;
+    std::mutex lock;
+    std::condition_variable changed;
+    bool closed;
+    bool finished;
+};
+
+// Parses compressed input without inflating all of it first. A second
+// thread inflates chunks while this one parses those before them, so
+// besides the document only a few chunks and the top level block being
+// parsed are held at a time.
+class CompressedParser {
+public:
+    static const size_t defaultChunk = 64 * 1024;
+
+    explicit CompressedParser(Document& document, size_t chunk = defaultChunk, size_t chunks = 4)
+    : parser(document), chunk(chunk), chunks(std::max<size_t>(chunks, 2)) {}
+
+    // Returns true when the whole input was parsed. Errors inflating the
+    // input are raised here once the parse has stopped.
+    bool parse(GzipSource& source) {
+        ChunkQueue queue(chunk, chunks);
+        std::exception_ptr failure;
+        std::thread inflater([&queue, &source, &failure] {inflate(queue, source, failure);});
+        bool parsed = true;
+        {
+            Join join(queue, inflater);
+            while (ChunkQueue::Chunk* next = queue.next()) {
+                parsed = parsed && parser.feed(&next->data[0], next->size);
+                queue.recycle(next);
+                if (!parsed) {
+                    queue.close();
+                }
+            }
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        return parser.finish() && parsed;
+    }
+
+    const ParseError& error() const {return parser.error();}
+
+private:
+    // Stops the inflating thread however the parse is left.
+    struct Join {
+        Join(ChunkQueue& queue, std::thread& thread) : queue(queue), thread(thread) {}
+        ~Join() {
+            queue.close();
+            thread.join();
+        }
+
+        ChunkQueue& queue;
+        std::thread& thread;
+    };
+
+    static void inflate(ChunkQueue& queue, GzipSource& source, std::exception_ptr& failure) {
+#ifndef YAMLPP_NO_EXCEPTIONS
+        try {
+#endif
+            while (ChunkQueue::Chunk* next = queue.take()) {
+                next->size = source.read(&next->data[0], next->data.size());
+                if (!next->size) {
+                    queue.recycle(next);
+                    break;
+                }
+                queue.put(next);
+            }
+#ifndef YAMLPP_NO_EXCEPTIONS
+        } catch (...) {
+            failure = std::current_exception();
+        }
+#endif
+        queue.finish();
+    }
+
+private:
+    CompressedParser(const CompressedParser&);
+    CompressedParser& operator=(const CompressedParser&);
+
+private:
+    PushParser parser;
+    size_t chunk;
+    size_t chunks;
+};
+
+#endif
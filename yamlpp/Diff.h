@@ -0,0 +1,201 @@
+#ifndef YAMLPP_DIFF_H
+#define YAMLPP_DIFF_H
+
+#include "Document.h"
+#include <map>
+#include <string>
+#include <vector>
+
+// A difference between two documents. The path is a JSON pointer: keys and
+// list indexes, each after a '/', with '~' and '/' in keys written as ~0
+// and ~1. The document's list is at /-, so its items are at /-/0, /-/1 and
+// so on.
+struct Change {
+    enum Kind {Added, Removed, Changed};
+
+    Change(Kind kind, const std::string& path) : kind(kind), path(path) {}
+
+    bool operator==(const Change& that) const {return kind == that.kind && path == that.path;}
+
+    Kind kind;
+    std::string path;
+};
+
+// Compares documents by the structural hashes of their lists and mappings,
+// which are taken to be equal without looking into them when their hashes
+// are. Lists and mappings cache their hashes, so a compare walks the top
+// level keys of both documents, compares scalars met on the way directly,
+// and descends only into the subtrees whose hashes differ. A hash is worked
+// out again only for the containers changed since it was last asked for.
+// Lists are compared item by item: items appended or removed at the end are
+// reported as such, while an item inserted elsewhere changes every item
+// after it.
+class Diff {
+public:
+    // Returns the changes from before to after, in key order, those to the
+    // list last. Documents whose hashes are equal are not walked at all.
+    static std::vector<Change> compare(const Document& before, const Document& after) {
+        std::vector<Change> changes;
+        if (before.hash() == after.hash()) {
+            return changes;
+        }
+        std::string path;
+        Lists lists;
+        entries(before, after, path, changes, &lists);
+        if (lists.first || lists.second) {
+            path = "/-";
+            if (!lists.first || !lists.second) {
+                changes.push_back(Change(lists.first ? Change::Removed : Change::Added, path));
+            } else if (lists.first->hash() != lists.second->hash()) {
+                items(*lists.first, *lists.second, path, changes);
+            }
+        }
+        return changes;
+    }
+
+    // Appends key to a JSON pointer.
+    static void appendKey(const std::string& key, std::string& path) {
+        path.push_back('/');
+        for (std::string::const_iterator it = key.begin(); it != key.end(); it++) {
+            if (*it == '~') {
+                path.append("~0");
+            } else if (*it == '/') {
+                path.append("~1");
+            } else {
+                path.push_back(*it);
+            }
+        }
+    }
+
+private:
+    typedef std::map<std::string, const boost::any*> Entries;
+
+    // The lists of the documents compared. They are kept under keys that
+    // differ from document to document, so they are set aside by the walk
+    // over the keys and compared with each other afterwards.
+    typedef std::pair<const List*, const List*> Lists;
+
+    // Entries merged with << are compared as if they were the container's
+    // own, which takes a sorted copy of the entry pointers. Containers
+    // without merges are walked as they are.
+    template<class Container>
+    static void entries(const Container& before, const Container& after, std::string& path, std::vector<Change>& changes, Lists* lists = 0) {
+        Entries beforeMerged(merged(before));
+        Entries afterMerged(merged(after));
+        if (beforeMerged.empty() && afterMerged.empty()) {
+            walk(before.begin(), before.end(), after.begin(), after.end(), path, changes, lists);
+            return;
+        }
+        own(before, beforeMerged);
+        own(after, afterMerged);
+        walk(beforeMerged.begin(), beforeMerged.end(), afterMerged.begin(), afterMerged.end(), path, changes, lists);
+    }
+
+    template<class Container>
+    static Entries merged(const Container& container) {
+        Entries entries;
+        container.forEachMerged([&entries](const std::string& key, const boost::any& value) {entries[key] = &value;});
+        return entries;
+    }
+
+    template<class Container>
+    static void own(const Container& container, Entries& entries) {
+        for (typename Container::const_iterator it = container.begin(); it != container.end(); it++) {
+            entries[it->first] = &it->second;
+        }
+    }
+
+    static const boost::any& value(const std::pair<const std::string, boost::any>& entry) {return entry.second;}
+    static const boost::any& value(const std::pair<const std::string, const boost::any*>& entry) {return *entry.second;}
+
+    // Walks two sorted ranges of entries side by side.
+    template<class Iterator>
+    static void walk(Iterator before, Iterator beforeEnd, Iterator after, Iterator afterEnd, std::string& path, std::vector<Change>& changes,
+                     Lists* lists) {
+        size_t length = path.size();
+        while (before != beforeEnd || after != afterEnd) {
+            if (lists && before != beforeEnd && setAside(value(*before), lists->first)) {
+                before++;
+            } else if (lists && after != afterEnd && setAside(value(*after), lists->second)) {
+                after++;
+            } else if (after == afterEnd || (before != beforeEnd && before->first < after->first)) {
+                appendKey(before->first, path);
+                changes.push_back(Change(Change::Removed, path));
+                before++;
+            } else if (before == beforeEnd || after->first < before->first) {
+                appendKey(after->first, path);
+                changes.push_back(Change(Change::Added, path));
+                after++;
+            } else {
+                appendKey(before->first, path);
+                values(value(*before), value(*after), path, changes);
+                before++;
+                after++;
+            }
+            path.resize(length);
+        }
+    }
+
+    static bool setAside(const boost::any& value, const List*& list) {
+        if (const List* found = boost::any_cast<List>(&value)) {
+            list = found;
+            return true;
+        }
+        return false;
+    }
+
+    static void values(const boost::any& beforeItem, const boost::any& afterItem, std::string& path, std::vector<Change>& changes) {
+        const boost::any& before = resolve(beforeItem);
+        const boost::any& after = resolve(afterItem);
+        const Mapping* beforeMapping = boost::any_cast<Mapping>(&before);
+        const Mapping* afterMapping = boost::any_cast<Mapping>(&after);
+        if (beforeMapping && afterMapping) {
+            if (beforeMapping->hash() != afterMapping->hash()) {
+                entries(*beforeMapping, *afterMapping, path, changes);
+            }
+            return;
+        }
+        const List* beforeList = boost::any_cast<List>(&before);
+        const List* afterList = boost::any_cast<List>(&after);
+        if (beforeList && afterList) {
+            if (beforeList->hash() != afterList->hash()) {
+                items(*beforeList, *afterList, path, changes);
+            }
+            return;
+        }
+        if (!sameScalar(before, after)) {
+            changes.push_back(Change(Change::Changed, path));
+        }
+    }
+
+    static bool sameScalar(const boost::any& before, const boost::any& after) {
+        if (const std::string* string = boost::any_cast<std::string>(&before)) {
+            const std::string* other = boost::any_cast<std::string>(&after);
+            return other && *string == *other;
+        }
+        if (const int* number = boost::any_cast<int>(&before)) {
+            const int* other = boost::any_cast<int>(&after);
+            return other && *number == *other;
+        }
+        return structuralHash(before) == structuralHash(after);
+    }
+
+    static void items(const List& before, const List& after, std::string& path, std::vector<Change>& changes) {
+        size_t length = path.size();
+        size_t count = std::max(before.count(), after.count());
+        for (size_t i = 0; i < count; i++) {
+            path.push_back('/');
+            path.append(std::to_string(i));
+            if (i >= before.count()) {
+                changes.push_back(Change(Change::Added, path));
+            } else if (i >= after.count()) {
+                changes.push_back(Change(Change::Removed, path));
+            } else {
+                values(before[i], after[i], path, changes);
+            }
+            path.resize(length);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,1564 @@
+#ifndef YAMLPP_DOCUMENT_H
+#define YAMLPP_DOCUMENT_H
+
+#include <boost/spirit.hpp>
+#include <boost/function.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/any.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+#include "Errors.h"
+#include "ParseStats.h"
+#include "ParseLimits.h"
+#include "Cancellation.h"
+#include "Utf8.h"
+#include "Scalar.h"
+#include "Skipper.h"
+#include "FlowMapping.h"
+#include "Schema.h"
+#include "ParseError.h"
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <type_traits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <ctime>
+
+using namespace boost::spirit;
+
+typedef boost::function2<void, const char*, const char*> grammar_cb;
+
+struct YamlGrammar : public grammar<YamlGrammar> {
+    YamlGrammar(grammar_cb& identifier, grammar_cb& string_value, grammar_cb& num_value, grammar_cb& list_item, grammar_cb& anchor) : identifier(identifier),
+    string_value(string_value), num_value(num_value), list_item(list_item), anchor(anchor) {
+    }
+
+    template<class ScannerT>
+    struct definition {
+        rule<ScannerT> property_id;
+        rule<ScannerT> string_value;
+        rule<ScannerT> num_value;
+        rule<ScannerT> property;
+        rule<ScannerT> list_item;
+        rule<ScannerT> anchor;
+        rule<ScannerT> yaml_line;
+        rule<ScannerT> yaml_document;
+
+        // Bytes of multibyte UTF-8 sequences count as letters. The input
+        // has been validated before parsing, so they always form whole
+        // characters.
+        range<char> non_ascii;
+        functor_parser<QuotedScalar> quoted;
+        functor_parser<BlockScalar> block;
+        functor_parser<FlowMapping> mapping;
+        chset<> name_char;
+
+        // Quoted and block scalars, flow mappings and aliases reach the
+        // callbacks with their quotes, block header, brace or *, which tell
+        // them apart from plain ones. An anchor is reported before the value
+        // it names.
+        definition(const YamlGrammar& self) : non_ascii('\x80', '\xff'), quoted(), block(), mapping(), name_char("a-zA-Z0-9_-") {
+            anchor = lexeme_d[ch_p('&') >> (+(non_ascii | name_char))[self.anchor]];
+            property_id = lexeme_d[quoted | str_p("<<") | +(non_ascii | alnum_p)];
+            string_value = lexeme_d[(ch_p('*') >> +(non_ascii | name_char)) | quoted | block | mapping | +(non_ascii | alpha_p)];
+            num_value = real_p;
+            property = property_id[self.identifier] >> ch_p(':') >> !anchor >> (num_value[self.num_value] | string_value[self.string_value]);
+            list_item = ch_p('-') >> !anchor >> lexeme_d[(ch_p('*') >> +(non_ascii | name_char)) | quoted | block | *(non_ascii | alnum_p)][self.list_item];
+            yaml_line = (list_item | property);
+            yaml_document = *yaml_line;
+        }
+
+        const rule<ScannerT>& start() {return yaml_document;}
+    };
+
+    grammar_cb& identifier;
+    grammar_cb& string_value;
+    grammar_cb& num_value;
+    grammar_cb& list_item;
+    grammar_cb& anchor;
+};
+
+inline bool isAlias(const char* first, const char* last) {
+    return first != last && *first == '*';
+}
+
+// A value given through an alias. Anchored values are kept behind a shared
+// pointer that every alias to them holds, so that an alias costs the same
+// whatever the size of the value. Copies of a document share them too.
+struct Alias {
+    explicit Alias(const boost::shared_ptr<boost::any>& target) : target(target) {}
+
+    boost::shared_ptr<boost::any> target;
+};
+
+// Returns the value an alias stands for, or the value itself.
+inline const boost::any& resolve(const boost::any& value) {
+    const Alias* alias = boost::any_cast<Alias>(&value);
+    return alias ? *alias->target : value;
+}
+
+inline boost::any& resolve(boost::any& value) {
+    Alias* alias = boost::any_cast<Alias>(&value);
+    return alias ? *alias->target : value;
+}
+
+// Returns the value, through an alias, as T, or none if there is no value
+// or it holds another type. T may be a const reference.
+template<class T>
+boost::optional<T> optionalAs(const boost::any* value) {
+    typedef typename std::remove_cv<typename std::remove_reference<T>::type>::type Held;
+    const Held* held = value ? boost::any_cast<Held>(&resolve(*value)) : 0;
+    return held ? boost::optional<T>(*held) : boost::optional<T>();
+}
+
+// A 64-bit hash of a value's content, through aliases, that does not
+// depend on the order of mapping entries. Lists and mappings cache theirs
+// until they are changed, so an unchanged subtree hashes in constant time.
+inline boost::uint64_t structuralHash(const boost::any& value);
+
+// Cleared lists keep their items' storage, which append() hands out again,
+// so that a reused list does not reallocate its items.
+class List {
+public:
+    List() : list(), items(0), hash_value(0) {}
+    List(const List& that) : list(that.list.begin(), that.list.begin() + that.items), items(that.items), hash_value(that.hash_value) {}
+    List(List&& that) : list(), items(0), hash_value(0) {swap(that);}
+    ~List() {}
+
+    List& operator=(List&& that) {
+        swap(that);
+        that.list.clear();
+        that.items = 0;
+        that.hash_value = 0;
+        return *this;
+    }
+
+    void swap(List& that) {
+        list.swap(that.list);
+        std::swap(items, that.items);
+        std::swap(hash_value, that.hash_value);
+    }
+
+    template<class T>
+    T& valueAs(size_t index) {
+        hash_value = 0;
+        return boost::any_cast<T&>(resolve(list[index]));
+    }
+
+    void add(const boost::any& item) {
+        append() = item;
+    }
+
+    void add(boost::any&& item) {
+        append() = std::move(item);
+    }
+
+    // Moves the items of that to the end of this list and clears that.
+    void splice(List& that) {
+        hash_value = 0;
+        list.reserve(items + that.items);
+        for (size_t i = 0; i < that.items; i++) {
+            add(std::move(that.list[i]));
+        }
+        that.clear();
+    }
+
+    // Returns a slot for a new last item. A slot left by clear() still holds
+    // its old value, which the caller may overwrite in place.
+    boost::any& append() {
+        hash_value = 0;
+        if (items == list.size()) {
+            list.push_back(boost::any());
+        }
+        return list[items++];
+    }
+
+    const boost::any& operator[](size_t index) const {return resolve(list[index]);}
+
+    // Returns the item at index, not through an alias, for changing it.
+    boost::any& modify(size_t index) {
+        hash_value = 0;
+        return list[index];
+    }
+
+    // Inserts item before index; index may be count().
+    void insert(size_t index, const boost::any& item) {
+        append() = item;
+        std::rotate(list.begin() + index, list.begin() + items - 1, list.begin() + items);
+    }
+
+    // Takes the item at index out of the list.
+    boost::any remove(size_t index) {
+        hash_value = 0;
+        boost::any item(std::move(list[index]));
+        std::move(list.begin() + index + 1, list.begin() + items, list.begin() + index);
+        list[--items] = boost::any();
+        return item;
+    }
+
+    // Like valueAs, but returns none instead of raising an error when index
+    // is out of range or the item holds another type.
+    template<class T>
+    boost::optional<T> tryGet(size_t index) const {
+        return optionalAs<T>(index < items ? &list[index] : 0);
+    }
+
+    size_t count() const {return items;}
+
+    void clear() {
+        items = 0;
+        hash_value = 0;
+    }
+
+    boost::uint64_t hash() const;
+
+private:
+    List& operator=(const List&);
+
+private:
+    std::vector<boost::any> list;
+    size_t items;
+    mutable boost::uint64_t hash_value;
+};
+
+class ScalarNotFoundException : public std::runtime_error {
+public:
+    explicit ScalarNotFoundException(const std::string& reason)
+    : std::runtime_error("Scalar '" + reason + "' not found.") {}
+};
+
+class UnknownAliasException : public std::runtime_error {
+public:
+    explicit UnknownAliasException(const std::string& alias)
+    : std::runtime_error("Alias '" + alias + "' has no anchor.") {}
+};
+
+class AliasLimitException : public LimitExceededException {
+public:
+    explicit AliasLimitException(size_t limit)
+    : LimitExceededException(Aliases, "Document has more than " + std::to_string(limit) + " aliases.") {}
+};
+
+class Mapping;
+
+typedef boost::function2<void, const std::string&, const boost::any&> entry_cb;
+
+// Mappings merged in with a << key. They are consulted in order for keys
+// that the merging mapping does not have itself. Where a key resolves to is
+// cached, so that after the first lookup of a key going through the merges
+// costs a single hash lookup. Merged mappings are shared, never copied.
+class MergeOverlay {
+public:
+    MergeOverlay() : bases(), cache() {}
+
+    void add(const boost::shared_ptr<boost::any>& base) {
+        bases.push_back(base);
+        cache.clear();
+    }
+
+    void clear() {
+        bases.clear();
+        cache.clear();
+    }
+
+    bool empty() const {return bases.empty();}
+
+    // Drops one merge for each of the merges in that: of the same mapping,
+    // or of one with the same content when it was given in place.
+    void remove(const MergeOverlay& that);
+
+    // Returns the merged value for key, or null if no merged mapping has it.
+    const boost::any* find(const std::string& key) const;
+
+    // Calls f(key, value) for every merged entry that is not overridden,
+    // either by local or by a mapping merged before it.
+    void forEach(const std::map<std::string, boost::any>& local, const entry_cb& f) const;
+
+    // Copies the merged entries that are not overridden into local.
+    void flattenInto(std::map<std::string, boost::any>& local);
+
+private:
+    static const Mapping& mapping(const boost::shared_ptr<boost::any>& base);
+
+private:
+    std::vector<boost::shared_ptr<boost::any> > bases;
+    mutable std::unordered_map<std::string, const boost::any*> cache;
+};
+
+// A flow mapping value, {key: value, ...}.
+class Mapping {
+public:
+    typedef std::map<std::string, boost::any>::const_iterator const_iterator;
+
+    Mapping() : values(), merges(), hash_value(0) {}
+
+    template<class T>
+    T valueAs(const std::string& key) const {
+        const boost::any* value = find(key);
+        if (!value) {
+            raiseError(ScalarNotFoundException(key));
+        }
+        return boost::any_cast<T>(resolve(*value));
+    }
+
+    // Returns the value for key, looking through merged mappings, or null.
+    const boost::any* find(const std::string& key) const {
+        const_iterator it(values.find(key));
+        return it != values.end() ? &it->second : merges.find(key);
+    }
+
+    template<class T>
+    boost::optional<T> tryGet(const std::string& key) const {return optionalAs<T>(find(key));}
+
+    boost::any& operator[](const std::string& key) {
+        hash_value = 0;
+        return values[key];
+    }
+
+    // Returns the mapping's own value for key, for changing it, or null.
+    boost::any* modify(const std::string& key) {
+        std::map<std::string, boost::any>::iterator it(values.find(key));
+        if (it == values.end()) {
+            return 0;
+        }
+        hash_value = 0;
+        return &it->second;
+    }
+
+    // Removes the mapping's own entry for key. Merged entries stay.
+    bool erase(const std::string& key) {
+        hash_value = 0;
+        return values.erase(key) > 0;
+    }
+
+    void merge(const boost::shared_ptr<boost::any>& base) {
+        hash_value = 0;
+        merges.add(base);
+    }
+
+    // Copies merged entries into the mapping itself, after which lookups
+    // no longer go through the merges.
+    void flatten() {
+        merges.flattenInto(values);
+        merges.clear();
+    }
+
+    // Calls f(key, value) for every entry, merged ones included.
+    void forEach(const entry_cb& f) const {
+        for (const_iterator it = values.begin(); it != values.end(); it++) {
+            f(it->first, it->second);
+        }
+        merges.forEach(values, f);
+    }
+
+    // Calls f(key, value) for the merged entries the mapping does not
+    // override.
+    void forEachMerged(const entry_cb& f) const {merges.forEach(values, f);}
+
+    // Iterates over the mapping's own entries only.
+    const_iterator begin() const {return values.begin();}
+    const_iterator end() const {return values.end();}
+
+    // Covers merged entries too. Changing a merged mapping does not clear
+    // the cached hash of the mappings merging it.
+    boost::uint64_t hash() const;
+
+private:
+    std::map<std::string, boost::any> values;
+    MergeOverlay merges;
+    mutable boost::uint64_t hash_value;
+};
+
+namespace hashing {
+
+// The finalizer of splitmix64.
+inline boost::uint64_t mix(boost::uint64_t h) {
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+inline boost::uint64_t bytes(const std::string& value, boost::uint64_t seed) {
+    boost::uint64_t h = 0xcbf29ce484222325ULL ^ seed;
+    for (std::string::const_iterator it = value.begin(); it != value.end(); it++) {
+        h = (h ^ static_cast<unsigned char>(*it)) * 0x100000001b3ULL;
+    }
+    return mix(h + value.size());
+}
+
+// Zero marks a hash that has not been computed yet.
+inline boost::uint64_t cached(boost::uint64_t h) {
+    return h ? h : 1;
+}
+
+enum Tag {Empty = 1, String, Int, Sequence, Map, Other};
+
+boost::uint64_t entry(const std::string& key, const boost::any& value);
+
+}
+
+inline boost::uint64_t structuralHash(const boost::any& item) {
+    const boost::any& value = resolve(item);
+    if (value.empty()) {
+        return hashing::mix(hashing::Empty);
+    }
+    if (const std::string* string = boost::any_cast<std::string>(&value)) {
+        return hashing::bytes(*string, hashing::String);
+    }
+    if (const int* number = boost::any_cast<int>(&value)) {
+        return hashing::mix(static_cast<boost::uint64_t>(static_cast<unsigned int>(*number)) ^ (boost::uint64_t(hashing::Int) << 32));
+    }
+    if (const Mapping* mapping = boost::any_cast<Mapping>(&value)) {
+        return mapping->hash();
+    }
+    if (const List* list = boost::any_cast<List>(&value)) {
+        return list->hash();
+    }
+    return hashing::bytes(value.type().name(), hashing::Other);
+}
+
+inline boost::uint64_t List::hash() const {
+    if (!hash_value) {
+        boost::uint64_t h = hashing::mix(hashing::Sequence + items);
+        for (size_t i = 0; i < items; i++) {
+            h = hashing::mix(h ^ structuralHash(list[i]));
+        }
+        hash_value = hashing::cached(h);
+    }
+    return hash_value;
+}
+
+// Entries are summed so that their order does not matter.
+inline boost::uint64_t hashing::entry(const std::string& key, const boost::any& value) {
+    return mix(bytes(key, 0) + 0x9e3779b97f4a7c15ULL * structuralHash(value));
+}
+
+inline boost::uint64_t Mapping::hash() const {
+    if (!hash_value) {
+        boost::uint64_t h = hashing::Map;
+        forEach([&h](const std::string& key, const boost::any& value) {
+            h += hashing::entry(key, value);
+        });
+        hash_value = hashing::cached(hashing::mix(h));
+    }
+    return hash_value;
+}
+
+inline void MergeOverlay::remove(const MergeOverlay& that) {
+    for (size_t j = 0; j < that.bases.size(); j++) {
+        for (size_t i = 0; i < bases.size(); i++) {
+            if (bases[i] == that.bases[j] || structuralHash(*bases[i]) == structuralHash(*that.bases[j])) {
+                bases.erase(bases.begin() + i);
+                break;
+            }
+        }
+    }
+    cache.clear();
+}
+
+inline const Mapping& MergeOverlay::mapping(const boost::shared_ptr<boost::any>& base) {
+    return boost::any_cast<const Mapping&>(resolve(*base));
+}
+
+inline const boost::any* MergeOverlay::find(const std::string& key) const {
+    if (bases.empty()) {
+        return 0;
+    }
+    std::unordered_map<std::string, const boost::any*>::const_iterator cached(cache.find(key));
+    if (cached != cache.end()) {
+        return cached->second;
+    }
+    const boost::any* value = 0;
+    for (size_t i = 0; i < bases.size() && !value; i++) {
+        value = mapping(bases[i]).find(key);
+    }
+    cache.emplace(key, value);
+    return value;
+}
+
+inline void MergeOverlay::forEach(const std::map<std::string, boost::any>& local, const entry_cb& f) const {
+    for (size_t i = 0; i < bases.size(); i++) {
+        mapping(bases[i]).forEach([&](const std::string& key, const boost::any& value) {
+            if (local.find(key) == local.end() && find(key) == &value) {
+                f(key, value);
+            }
+        });
+    }
+}
+
+inline void MergeOverlay::flattenInto(std::map<std::string, boost::any>& local) {
+    std::vector<std::pair<std::string, const boost::any*> > merged;
+    forEach(local, [&](const std::string& key, const boost::any& value) {
+        merged.push_back(std::make_pair(key, &value));
+    });
+    for (size_t i = 0; i < merged.size(); i++) {
+        local[merged[i].first] = *merged[i].second;
+    }
+}
+
+class Document {
+    friend class Cbor;
+    friend class MessagePack;
+    friend class PushParser;
+    friend class ParallelParser;
+    friend class Patch;
+
+    typedef std::map<std::string, boost::any>::node_type Node;
+
+public:
+    typedef std::map<std::string, boost::any>::const_iterator const_iterator;
+
+    static const size_t defaultAliasLimit = ParseLimits::defaultAliases;
+    static const size_t defaultProgressInterval = 64 * 1024;
+
+    Document() : values(), hash_value(0), current_id(), list_key(), redefined_keys(false), collect_stats(false), parse_stats(), active_stats(0), keep_comments(false), comments(),
+    pending_comment(), last_comment(0), anchors(), merges(), pending_anchor(), alias_name(), limits(), active_limits(0), alias_count(0), node_count(0), byte_count(0), active_token(0), active_progress(0),
+    progress_interval(defaultProgressInterval), progress_first(0), next_checkpoint(0),
+    active_schema(0), current_rule(0), schema_seen(), input_first(0), stream_offset(0), stream_lines(0), stream_live(0), parse_error(), record_positions(false), positions(), position_mark(0),
+    position_line(1), spare_nodes(), spare_lists(), cached_grammar() {}
+
+    Document(const Document& that) : values(that.values), hash_value(that.hash_value), current_id(that.current_id), list_key(that.list_key), redefined_keys(that.redefined_keys), collect_stats(that.collect_stats),
+    parse_stats(that.parse_stats), active_stats(0), keep_comments(that.keep_comments), comments(that.comments),
+    pending_comment(), last_comment(0), anchors(that.anchors), merges(that.merges), pending_anchor(), alias_name(), limits(that.limits), active_limits(0), alias_count(0), node_count(0), byte_count(0), active_token(0), active_progress(0),
+    progress_interval(defaultProgressInterval), progress_first(0), next_checkpoint(0),
+    active_schema(0), current_rule(0), schema_seen(), input_first(0), stream_offset(0), stream_lines(0), stream_live(0), parse_error(), record_positions(that.record_positions), positions(that.positions), position_mark(0),
+    position_line(1), spare_nodes(), spare_lists(), cached_grammar() {}
+
+    // Moving a document transfers its nodes; nothing is copied or allocated.
+    Document(Document&& that) : values(), hash_value(0), current_id(), list_key(), redefined_keys(false), collect_stats(false), parse_stats(), active_stats(0), keep_comments(false), comments(),
+    pending_comment(), last_comment(0), anchors(), merges(), pending_anchor(), alias_name(), limits(), active_limits(0), alias_count(0), node_count(0), byte_count(0), active_token(0), active_progress(0),
+    progress_interval(defaultProgressInterval), progress_first(0), next_checkpoint(0),
+    active_schema(0), current_rule(0), schema_seen(), input_first(0), stream_offset(0), stream_lines(0), stream_live(0), parse_error(), record_positions(false), positions(), position_mark(0),
+    position_line(1), spare_nodes(), spare_lists(), cached_grammar() {
+        swap(that);
+    }
+
+    Document& operator=(const Document& that) {
+        Document copy(that);
+        swap(copy);
+        return *this;
+    }
+
+    Document& operator=(Document&& that) {
+        Document moved(std::move(that));
+        swap(moved);
+        return *this;
+    }
+
+    // The grammar stays with the document it was built for.
+    void swap(Document& that) {
+        values.swap(that.values);
+        std::swap(hash_value, that.hash_value);
+        current_id.swap(that.current_id);
+        list_key.swap(that.list_key);
+        std::swap(redefined_keys, that.redefined_keys);
+        std::swap(collect_stats, that.collect_stats);
+        std::swap(parse_stats, that.parse_stats);
+        std::swap(keep_comments, that.keep_comments);
+        comments.swap(that.comments);
+        anchors.swap(that.anchors);
+        std::swap(merges, that.merges);
+        std::swap(record_positions, that.record_positions);
+        positions.swap(that.positions);
+        std::swap(limits, that.limits);
+        spare_nodes.swap(that.spare_nodes);
+        spare_lists.swap(that.spare_lists);
+    }
+
+    // Empties the document but keeps its map nodes, strings and lists for
+    // the next parse. Parsing a document of the same shape again after a
+    // reset does not allocate.
+    void reset() {
+        while (!values.empty()) {
+            Node node(values.extract(values.begin()));
+            if (List* list = boost::any_cast<List>(&node.mapped())) {
+                list->clear();
+                spare_lists.push_back(std::move(node));
+            } else {
+                spare_nodes.push_back(std::move(node));
+            }
+        }
+        hash_value = 0;
+        current_id.clear();
+        redefined_keys = false;
+        comments.clear();
+        anchors.clear();
+        merges.clear();
+        positions.clear();
+        parse_stats = ParseStats();
+    }
+
+    // Frees everything the document holds, including the nodes reset()
+    // keeps for reuse.
+    void release() {
+        reset();
+        std::vector<Node>().swap(spare_nodes);
+        std::vector<Node>().swap(spare_lists);
+        std::string().swap(current_id);
+        std::string().swap(pending_comment);
+        std::string().swap(pending_anchor);
+    }
+
+    static parse_info<> parseInto(const std::string& data, Document& document) {
+        document.reset();
+        return document.parse(data);
+    }
+
+    parse_info<> parse(const std::string& data) {
+        input_first = data.c_str();
+        return parse(data.c_str(), data.c_str() + data.size());
+    }
+
+    // Parses data and checks it against schema while it is read, so that a
+    // bad document is rejected at the first offending value. A rejected
+    // document is left empty and ValidationException tells where the
+    // problem is. Required keys are checked once the whole input has been
+    // parsed; keys merged with << count as present.
+    parse_info<> parse(const std::string& data, const CompiledSchema& schema) {
+        const char* last = data.c_str() + data.size();
+        active_schema = &schema;
+        schema_seen.assign(schema.size(), 0);
+        input_first = data.c_str();
+        ClearOnExit<const CompiledSchema> clear(active_schema);
+        parse_info<> info = parse(data.c_str(), last);
+        if (info.full) {
+            checkRequired(last);
+        }
+        return info;
+    }
+
+    // Parses data within limits instead of the document's own, for input
+    // that cannot be trusted. A parse that goes over a limit is abandoned:
+    // the document is emptied, its memory released, and
+    // LimitExceededException tells which limit was hit.
+    parse_info<> parse(const std::string& data, const ParseLimits& limits) {
+        active_limits = &limits;
+        ClearOnExit<const ParseLimits> clear(active_limits);
+        return parse(data);
+    }
+
+    // Parses data while letting token stop it, for parses that may no longer
+    // be wanted once they finish. The token is checked, and progress called
+    // with the bytes parsed so far, at the first top level key or list item
+    // after every interval bytes, and progress once more at the end. A
+    // cancelled parse leaves the document empty and raises
+    // ParseCancelledException.
+    parse_info<> parse(const std::string& data, const CancellationToken& token, const progress_cb& progress = progress_cb(),
+                       size_t interval = defaultProgressInterval) {
+        active_token = &token;
+        active_progress = &progress;
+        progress_interval = std::max<size_t>(interval, 1);
+        ClearOnExit<const CancellationToken> clearToken(active_token);
+        ClearOnExit<const progress_cb> clearProgress(active_progress);
+        parse_info<> info = parse(data);
+        if (info.full && progress) {
+            progress(data.size());
+        }
+        return info;
+    }
+
+    // Replaces length bytes at offset in a previously parsed buffer with text
+    // and re-parses only the block enclosing the edit. A block is a top level
+    // line together with the lines that continue it: indented lines, and
+    // blank lines followed by indented ones. An edit touching list items
+    // re-parses the whole run of items. Merges made by the edited block are
+    // dropped before it is parsed again, as are the comments and positions
+    // of its keys; the comment lines above the block are parsed with it when
+    // comments are kept. The whole buffer is parsed again when the edit touches an
+    // anchor, whose aliases would otherwise keep the old value, when it
+    // touches list items while the list has items elsewhere, when it
+    // changes a kept comment, when a key is given a value more than once,
+    // so that which one wins depends on the rest of the buffer, or when the
+    // block does not parse in full.
+    parse_info<> edit(std::string& data, size_t offset, size_t length, const std::string& text) {
+        if (offset > data.size()) {
+            raiseError(std::out_of_range("Edit offset is past the end of data"));
+        }
+        length = std::min(length, data.size() - offset);
+        hash_value = 0;
+        size_t begin = blockStart(data, lineStart(data, offset));
+        size_t end = blockEnd(data, lineEnd(data, offset + length));
+        while (keep_comments && begin > 0 && data[lineStart(data, begin - 1)] == '#') {
+            begin = lineStart(data, begin - 1);
+        }
+        size_t newEnd = end + text.size() - length;
+        std::string edited(data, begin, offset - begin);
+        edited.append(text).append(data, offset + length, end - offset - length);
+        bool touchesList = hasListItem(data, begin, end) || hasListItem(edited, 0, edited.size());
+        if (touchesList) {
+            while (begin > 0 && isListItem(data, blockStart(data, lineStart(data, begin - 1)))) {
+                begin = blockStart(data, lineStart(data, begin - 1));
+            }
+            while (end < data.size() && isListItem(data, end + 1)) {
+                end = blockEnd(data, lineEnd(data, end + 1));
+            }
+            newEnd = end + text.size() - length;
+        }
+        List* list = touchesList ? findList() : 0;
+        bool whole = redefined_keys || (keep_comments && (data.find('#', offset) < offset + length || text.find('#') != std::string::npos))
+            || std::memchr(data.c_str() + begin, '&', end - begin) || text.find('&') != std::string::npos
+            || (touchesList && list && listItems(data, begin, end) != list->count());
+        if (whole) {
+            data.replace(offset, length, text);
+            reset();
+            return parse(data);
+        }
+
+        // The old block defines no anchors, so it is parsed against the
+        // document's own, lent to it for the parse.
+        Document old;
+        {
+            AnchorLoan loan(anchors, old.anchors);
+            old.parse(data.c_str() + begin, data.c_str() + end);
+        }
+        for (std::map<std::string, boost::any>::iterator it = old.values.begin(); it != old.values.end(); it++) {
+            if (it->second.type() != typeid(List)) {
+                values.erase(it->first);
+                comments.erase(it->first);
+                positions.erase(it->first);
+            }
+        }
+        merges.remove(old.merges);
+
+        data.replace(offset, length, text);
+        input_first = data.c_str();
+
+        current_id.clear();
+        if (list) {
+            list->clear();
+            current_id = list_key;
+        }
+        parse_info<> info = parse(data.c_str() + begin, data.c_str() + newEnd);
+        if (!info.full || redefined_keys) {
+            reset();
+            return parse(data);
+        }
+        return info;
+    }
+
+    template<class T>
+    T valueAs(const std::string& key) {
+        hash_value = 0;
+        std::map<std::string, boost::any>::iterator it(values.find(key));
+        if (it != values.end()) {
+            return boost::any_cast<T>(resolve(it->second));
+        }
+        const boost::any* merged = merges.find(key);
+        if (!merged) {
+            raiseError(ScalarNotFoundException(key));
+        }
+        return boost::any_cast<T>(resolve(*merged));
+    }
+
+    // Returns the value for key, looking through merged mappings, or null.
+    const boost::any* find(const std::string& key) const {
+        const_iterator it(values.find(key));
+        return it != values.end() ? &it->second : merges.find(key);
+    }
+
+    // Like valueAs, but returns none instead of raising an error when the
+    // key is missing or its value has another type, so lookups that may
+    // fail cost no exception:
+    //
+    //   int port = document.tryGet<int>("port").value_or(80);
+    //   if (boost::optional<const Mapping&> server = document.tryGet<const Mapping&>("server")) ...
+    template<class T>
+    boost::optional<T> tryGet(const std::string& key) const {return optionalAs<T>(find(key));}
+
+    // Mappings merged into the document with << keys are consulted by
+    // valueAs but not iterated over by begin() and end(). forEachMerged
+    // visits their entries that the document does not override, and
+    // flattenMerges copies those entries into the document itself.
+    void forEachMerged(const entry_cb& f) const {merges.forEach(values, f);}
+
+    void flattenMerges() {
+        hash_value = 0;
+        merges.flattenInto(values);
+        merges.clear();
+    }
+
+    // Describes why the last parse stopped early. Its position is worked
+    // out when asked for, from the input, which must still be alive.
+    const ParseError& error() const {return parse_error;}
+
+    // Source positions of keys are recorded while enabled, for tools that
+    // point back into the input.
+    void recordPositions(bool enabled) {record_positions = enabled;}
+
+    SourcePosition position(const std::string& key) const {
+        std::map<std::string, SourcePosition>::const_iterator it(positions.find(key));
+        if (it == positions.end()) {
+            raiseError(ScalarNotFoundException(key));
+        }
+        return it->second;
+    }
+
+    // Limits for every parse of the document. By default only aliases are
+    // limited.
+    void parseLimits(const ParseLimits& limits) {this->limits = limits;}
+    const ParseLimits& parseLimits() const {return limits;}
+
+    // Caps the number of aliases in a single parse. A parse that goes over
+    // the limit throws AliasLimitException, a LimitExceededException.
+    void aliasLimit(size_t limit) {limits.aliases = limit;}
+
+    // Statistics are collected for parses made while collection is enabled
+    // here or through ParseStatsRegistry.
+    void collectStats(bool enabled) {collect_stats = enabled;}
+    const ParseStats& stats() const {return parse_stats;}
+
+    // Comments are skipped unless kept here. Kept comments are attached to
+    // the key that follows them, one line of text per comment line, without
+    // the #. Comments before list items are not kept.
+    void keepComments(bool enabled) {keep_comments = enabled;}
+
+    const std::string& comment(const std::string& key) const {
+        static const std::string none;
+        std::map<std::string, std::string>::const_iterator it(comments.find(key));
+        return it == comments.end() ? none : it->second;
+    }
+
+    const_iterator begin() const {return values.begin();}
+    const_iterator end() const {return values.end();}
+
+    // Hashes the content like Mapping::hash, with the list hashed apart
+    // from the key it is kept under. The hash is cached until the document
+    // is parsed, edited, patched or handed out for changing through
+    // valueAs, list or findList; changing a value through a reference kept
+    // from before the hash was taken does not clear it.
+    boost::uint64_t hash() const {
+        if (!hash_value) {
+            static const std::string listKey("-");
+            boost::uint64_t h = hashing::Map;
+            for (const_iterator it = values.begin(); it != values.end(); it++) {
+                h += hashing::entry(boost::any_cast<List>(&it->second) ? listKey : it->first, it->second);
+            }
+            forEachMerged([&h](const std::string& key, const boost::any& value) {
+                h += hashing::entry(key, value);
+            });
+            hash_value = hashing::cached(hashing::mix(h));
+        }
+        return hash_value;
+    }
+
+    List& list() {
+        List* found = findList();
+        if (!found) {
+            raiseError(std::string("List not found"));
+        }
+        return *found;
+    }
+
+    // Returns the document's list, or null if it has none. The key the list
+    // was last found under is tried first, so that finding it again does
+    // not walk the document.
+    List* findList() {
+        hash_value = 0;
+        std::map<std::string, boost::any>::iterator hint(values.find(list_key));
+        if (hint != values.end()) {
+            if (List* found = boost::any_cast<List>(&hint->second)) {
+                return found;
+            }
+        }
+        for (std::map<std::string, boost::any>::iterator it = values.begin(); it != values.end(); it++) {
+            if (List* found = boost::any_cast<List>(&it->second)) {
+                list_key = it->first;
+                return found;
+            }
+        }
+        return 0;
+    }
+
+private:
+    // A chunk of a stream adds to the counts and statistics of the chunks
+    // before it, and is recorded with them when the stream finishes.
+    parse_info<> parse(const char* first, const char* last, bool chunk = false) {
+        hash_value = 0;
+        if (!chunk) {
+            startStream();
+        }
+        ParseStatsRegistry& registry(ParseStatsRegistry::global());
+        if (!collect_stats && !registry.enabled()) {
+            return run(first, last);
+        }
+        AllocationCounter counter;
+        double total = 0;
+        double phases = parse_stats.build_seconds + parse_stats.convert_seconds;
+        parse_info<> info;
+        active_stats = &parse_stats;
+        {
+            ClearOnExit<ParseStats> clear(active_stats);
+            PhaseTimer timer(&total);
+            info = run(first, last);
+        }
+        parse_stats.allocations += counter.allocations;
+        parse_stats.bytes += counter.bytes;
+        parse_stats.peak_bytes = std::max(parse_stats.peak_bytes, static_cast<size_t>(std::max(0L, stream_live + counter.peak)));
+        stream_live += counter.live;
+        phases = parse_stats.build_seconds + parse_stats.convert_seconds - phases;
+        parse_stats.scan_seconds += std::max(0.0, total - phases);
+        if (!chunk) {
+            finishStream();
+        }
+        return info;
+    }
+
+    // Starts a stream of input that parseChunk() parses piece by piece:
+    // limits apply to what all the pieces build together, statistics
+    // describe them all, and errors are located in the stream rather than
+    // in the piece they are in.
+    void startStream() {
+        alias_count = 0;
+        node_count = 0;
+        byte_count = 0;
+        stream_offset = 0;
+        stream_lines = 0;
+        stream_live = 0;
+        hash_value = 0;
+        if (collect_stats || ParseStatsRegistry::global().enabled()) {
+            parse_stats = ParseStats();
+        }
+    }
+
+    // Records the statistics of the stream, as those of a single parse.
+    void finishStream() {
+        ParseStatsRegistry& registry(ParseStatsRegistry::global());
+        if (registry.enabled()) {
+            registry.record(parse_stats);
+        }
+    }
+
+    // Parses the next piece of the stream, which starts at a top level line,
+    // into what has been parsed so far.
+    parse_info<> parseChunk(const char* first, const char* last) {
+        input_first = first;
+        parse_info<> info = parse(first, last, true);
+        if (info.full) {
+            skipChunk(first, last);
+        }
+        return info;
+    }
+
+    // Moves the stream past a piece that was not parsed, such as blank lines.
+    void skipChunk(const char* first, const char* last) {
+        stream_offset += last - first;
+        stream_lines += countNewlines(first, last);
+    }
+
+    // Adds what a piece of the stream parsed into another document built to
+    // the counts and statistics, and checks the total against the limits.
+    // Pieces are parsed side by side, so their peaks add up.
+    void countChunk(const Document& piece) {
+        parse_stats.allocations += piece.parse_stats.allocations;
+        parse_stats.bytes += piece.parse_stats.bytes;
+        parse_stats.peak_bytes += piece.parse_stats.peak_bytes;
+        parse_stats.scan_seconds += piece.parse_stats.scan_seconds;
+        parse_stats.build_seconds += piece.parse_stats.build_seconds;
+        parse_stats.convert_seconds += piece.parse_stats.convert_seconds;
+        const ParseLimits& limit = currentLimits();
+        alias_count += piece.alias_count;
+        node_count += piece.node_count;
+        byte_count += piece.byte_count;
+        if (alias_count > limit.aliases) {
+            release();
+            raiseError(AliasLimitException(limit.aliases));
+        }
+        if (node_count > limit.nodes) {
+            exceed(LimitExceededException::Nodes, "Document has more than " + std::to_string(limit.nodes) + " nodes.");
+        }
+        if (byte_count > limit.bytes) {
+            exceed(LimitExceededException::Bytes, "Document needs more than " + std::to_string(limit.bytes) + " bytes.");
+        }
+    }
+
+    // Invalid UTF-8 fails the parse at the offending byte before any of
+    // the document is built.
+    parse_info<> run(const char* first, const char* last) {
+        const char* invalid = validateUtf8(first, last);
+        if (invalid != last) {
+            parse_error = ParseError(input_first, invalid, last, stream_offset, stream_lines);
+            return parse_info<>(invalid, false, false, 0);
+        }
+        if (!cached_grammar) {
+            cached_grammar.reset(new Grammar(this));
+        }
+        pending_comment.clear();
+        last_comment = 0;
+        pending_anchor.clear();
+        progress_first = first;
+        next_checkpoint = active_token ? first : 0;
+        if (pastDeadline()) {
+            exceed(LimitExceededException::Deadline, "Document was not parsed before its deadline.");
+        }
+        current_rule = 0;
+        position_mark = input_first;
+        position_line = 1 + stream_lines;
+        functor_parser<Skipper> skipper(Skipper(keep_comments ? &cached_grammar->comment_f : 0));
+        parse_info<> info(skipTrailingBlank(boost::spirit::parse(first, last, cached_grammar->grammar >> eps_p, skipper), last));
+        parse_error = info.full ? ParseError() : ParseError(input_first, info.stop, last, stream_offset, stream_lines);
+        return info;
+    }
+
+    // Returns the value node for key, reusing a node kept by reset() when
+    // the key is new.
+    boost::any& node(const std::string& key, std::vector<Node>& spares) {
+        std::map<std::string, boost::any>::iterator it(values.lower_bound(key));
+        if (it != values.end() && it->first == key) {
+            redefined_keys = true;
+            return it->second;
+        }
+        if (spares.empty()) {
+            return values.emplace_hint(it, key, boost::any())->second;
+        }
+        Node spare(std::move(spares.back()));
+        spares.pop_back();
+        spare.key().assign(key);
+        return values.insert(it, std::move(spare))->second;
+    }
+
+    // Stores a scalar or mapping or, for an alias, a reference to the
+    // anchored value. A mapping's anchor is defined only once the mapping
+    // is complete, so that a mapping cannot refer to itself.
+    void store(boost::any& node, const char* start, const char* end, size_t depth) {
+        if (isAlias(start, end)) {
+            node = Alias(aliasTarget(start, end));
+            pending_anchor.clear();
+        } else if (isFlowMapping(start, end) && !pending_anchor.empty()) {
+            boost::shared_ptr<boost::any> shared(boost::make_shared<boost::any>());
+            buildMapping(*shared, start, end, depth);
+            anchors[pending_anchor] = shared;
+            pending_anchor.clear();
+            node = Alias(shared);
+        } else if (isFlowMapping(start, end)) {
+            buildMapping(node, start, end, depth);
+        } else {
+            assign(anchored(node), start, end);
+        }
+    }
+
+    const boost::shared_ptr<boost::any>& aliasTarget(const char* start, const char* end) {
+        if (++alias_count > currentLimits().aliases) {
+            release();
+            raiseError(AliasLimitException(currentLimits().aliases));
+        }
+        alias_name.assign(start + 1, end);
+        std::map<std::string, boost::shared_ptr<boost::any> >::const_iterator it(anchors.find(alias_name));
+        if (it == anchors.end()) {
+            raiseError(UnknownAliasException(alias_name));
+        }
+        return it->second;
+    }
+
+    // Returns the mapping a << key merges: the anchored mapping an alias
+    // names, or a mapping given in place.
+    boost::shared_ptr<boost::any> mergeTarget(const char* start, const char* end) {
+        boost::shared_ptr<boost::any> target;
+        if (isAlias(start, end)) {
+            target = aliasTarget(start, end);
+        } else if (isFlowMapping(start, end)) {
+            target = boost::make_shared<boost::any>();
+            buildMapping(*target, start, end, 1);
+        }
+        if (!target || resolve(*target).type() != typeid(Mapping)) {
+            raiseError(std::runtime_error("Merge key '<<' needs a mapping"));
+        }
+        return target;
+    }
+
+    void buildMapping(boost::any& node, const char* start, const char* end, size_t depth) {
+        FlowBuilder builder(*this, node, depth);
+        scanFlowMapping(start, end, builder);
+    }
+
+    const ParseLimits& currentLimits() const {
+        return active_limits ? *active_limits : limits;
+    }
+
+    // Counts a value and the bytes it holds beyond its node against the
+    // limits. The clock is only read for every 256th value.
+    void countNode(size_t size) {
+        const ParseLimits& limit = currentLimits();
+        if (++node_count > limit.nodes) {
+            exceed(LimitExceededException::Nodes, "Document has more than " + std::to_string(limit.nodes) + " nodes.");
+        }
+        byte_count += nodeBytes + size;
+        if (byte_count > limit.bytes) {
+            exceed(LimitExceededException::Bytes, "Document needs more than " + std::to_string(limit.bytes) + " bytes.");
+        }
+        if (!(node_count & 255) && pastDeadline()) {
+            exceed(LimitExceededException::Deadline, "Document was not parsed before its deadline.");
+        }
+    }
+
+    // A flow mapping is counted entry by entry as it is built.
+    void countValue(size_t key_length, const char* start, const char* end) {
+        if (isFlowMapping(start, end)) {
+            countNode(key_length);
+            return;
+        }
+        checkLength(start, end);
+        countNode(key_length + (end - start));
+    }
+
+    void checkDepth(size_t depth) {
+        if (depth > currentLimits().depth) {
+            exceed(LimitExceededException::Depth, "Document is nested deeper than " + std::to_string(currentLimits().depth) + " levels.");
+        }
+    }
+
+    void checkLength(const char* start, const char* end) {
+        if (static_cast<size_t>(end - start) > currentLimits().scalar_length) {
+            exceed(LimitExceededException::ScalarLength,
+                   "Document has a scalar longer than " + std::to_string(currentLimits().scalar_length) + " bytes.");
+        }
+    }
+
+    // Called at block boundaries, where at is the start of the block.
+    void checkpoint(const char* at) {
+        if (active_token->cancelled()) {
+            reset();
+            raiseError(ParseCancelledException());
+        }
+        if (*active_progress) {
+            (*active_progress)(at - progress_first);
+        }
+        next_checkpoint = at + progress_interval;
+    }
+
+    bool pastDeadline() const {
+        const ParseLimits::Clock::time_point& deadline = currentLimits().deadline;
+        return deadline != ParseLimits::Clock::time_point() && ParseLimits::Clock::now() > deadline;
+    }
+
+    // Abandons the parse. The document's memory is released before the
+    // error is raised, not when the document goes away.
+    [[noreturn]] void exceed(LimitExceededException::Limit limit, const std::string& message) {
+        release();
+        raiseError(LimitExceededException(limit, message));
+    }
+
+    // Returns where the value for node is stored: node itself, or a shared
+    // value that node refers to if the value has an anchor.
+    boost::any& anchored(boost::any& node) {
+        if (pending_anchor.empty()) {
+            return node;
+        }
+        boost::shared_ptr<boost::any> shared(boost::make_shared<boost::any>());
+        anchors[pending_anchor] = shared;
+        pending_anchor.clear();
+        node = Alias(shared);
+        return *shared;
+    }
+
+    static void assign(boost::any& node, const char* start, const char* end) {
+        if (std::string* text = boost::any_cast<std::string>(&node)) {
+            scalarText(start, end, *text);
+        } else {
+            node = std::string();
+            scalarText(start, end, boost::any_cast<std::string&>(node));
+        }
+    }
+
+    static size_t lineStart(const std::string& data, size_t pos) {
+        if (pos == 0) {
+            return 0;
+        }
+        size_t newline = data.rfind('\n', pos - 1);
+        return newline == std::string::npos ? 0 : newline + 1;
+    }
+
+    static size_t lineEnd(const std::string& data, size_t pos) {
+        size_t newline = data.find('\n', pos);
+        return newline == std::string::npos ? data.size() : newline;
+    }
+
+    static bool isIndented(const std::string& data, size_t start) {
+        if (start >= data.size() || (data[start] != ' ' && data[start] != '\t')) {
+            return false;
+        }
+        size_t first = data.find_first_not_of(" \t", start);
+        return first != std::string::npos && data[first] != '\n' && data[first] != '\r';
+    }
+
+    static bool isBlank(const std::string& data, size_t start) {
+        size_t first = data.find_first_not_of(" \t\r", start);
+        return first == std::string::npos || data[first] == '\n';
+    }
+
+    // Returns the start of the top level line whose block has the line at
+    // start in it.
+    static size_t blockStart(const std::string& data, size_t start) {
+        while (start > 0 && (isIndented(data, start) || isBlank(data, start))) {
+            start = lineStart(data, start - 1);
+        }
+        return start;
+    }
+
+    // Returns the end of the block going on past the line ending at end. As
+    // with findBlockEnd, blank lines belong to the block when an indented
+    // line follows them.
+    static size_t blockEnd(const std::string& data, size_t end) {
+        for (size_t line = end + 1; line < data.size(); line = lineEnd(data, line) + 1) {
+            if (isIndented(data, line)) {
+                end = lineEnd(data, line);
+            } else if (!isBlank(data, line)) {
+                break;
+            }
+        }
+        return end;
+    }
+
+    static size_t listItems(const std::string& data, size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t start = begin; start <= end && start < data.size(); start = lineEnd(data, start) + 1) {
+            count += isListItem(data, start);
+        }
+        return count;
+    }
+
+    // List items are top level lines; a - further in is part of a block.
+    static bool isListItem(const std::string& data, size_t start) {
+        return start < data.size() && data[start] == '-';
+    }
+
+    static bool hasListItem(const std::string& data, size_t begin, size_t end) {
+        for (size_t start = begin; start <= end && start < data.size(); start = lineEnd(data, start) + 1) {
+            if (isListItem(data, start)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    double* phase(double ParseStats::*seconds) {
+        return active_stats ? &(active_stats->*seconds) : 0;
+    }
+
+    void id(const char* start, const char* end) {
+        PhaseTimer timer(phase(&ParseStats::build_seconds));
+        if (next_checkpoint && start >= next_checkpoint) {
+            checkpoint(start);
+        }
+        checkLength(start, end);
+        scalarText(start, end, current_id);
+        if (!pending_comment.empty()) {
+            comments[current_id].swap(pending_comment);
+            pending_comment.clear();
+        }
+        if (active_schema) {
+            checkKey(start);
+        }
+        if (record_positions) {
+            positions[current_id] = locate(start);
+        }
+    }
+
+    void anchor(const char* start, const char* end) {
+        pending_anchor.assign(start, end);
+    }
+
+    void comment_text(const char* start, const char* end) {
+        if (start <= last_comment) {
+            return;
+        }
+        last_comment = start;
+        if (!pending_comment.empty()) {
+            pending_comment.push_back('\n');
+        }
+        pending_comment.append(start, end);
+    }
+
+    void value(const char* start, const char* end) {
+        PhaseTimer timer(phase(&ParseStats::build_seconds));
+        if (current_id == "<<") {
+            merges.add(mergeTarget(start, end));
+            pending_anchor.clear();
+            return;
+        }
+        countValue(current_id.size(), start, end);
+        boost::any& stored = node(current_id, spare_nodes);
+        store(stored, start, end, 1);
+        if (current_rule) {
+            checkValue(stored, start);
+        }
+    }
+
+    void num_value(const char* start, const char* end) {
+        checkLength(start, end);
+        countNode(current_id.size());
+        int value;
+        {
+            PhaseTimer timer(phase(&ParseStats::convert_seconds));
+            value = static_cast<int>(strtol(start, NULL, 10));
+        }
+        PhaseTimer timer(phase(&ParseStats::build_seconds));
+        boost::any& stored = node(current_id, spare_nodes);
+        boost::any& number = anchored(stored);
+        if (int* existing = boost::any_cast<int>(&number)) {
+            *existing = value;
+        } else {
+            number = value;
+        }
+        if (current_rule) {
+            checkValue(stored, start);
+        }
+    }
+
+    void list_item(const char* start, const char* end) {
+        PhaseTimer timer(phase(&ParseStats::build_seconds));
+        if (next_checkpoint && start >= next_checkpoint) {
+            checkpoint(start);
+        }
+        countValue(0, start, end);
+        List& list = getOrCreateList();
+        boost::any& item = list.append();
+        store(item, start, end, 2);
+        pending_comment.clear();
+        if (active_schema && active_schema->itemTypes() && !(active_schema->itemTypes() & schemaType(resolve(item)))) {
+            reject("List item has the wrong type", start);
+        }
+    }
+
+    void checkKey(const char* at) {
+        current_rule = current_id == "<<" ? 0 : active_schema->find(current_id);
+        if (current_rule) {
+            schema_seen[current_rule->index] = 1;
+        } else if (active_schema->closed() && current_id != "<<") {
+            reject("Key '" + current_id + "' is not allowed", at);
+        }
+    }
+
+    void checkValue(const boost::any& node, const char* at) {
+        const boost::any& value = resolve(node);
+        const char* reason = CompiledSchema::check(*current_rule, schemaType(value), boost::any_cast<int>(&value), boost::any_cast<std::string>(&value));
+        if (reason) {
+            reject("Value of '" + current_id + "' " + reason, at);
+        }
+    }
+
+    void checkRequired(const char* last) {
+        for (size_t i = 0; i < active_schema->size(); i++) {
+            const CompiledSchema::Rule& rule = active_schema->rule(i);
+            if (rule.required && !schema_seen[i] && !merges.find(rule.key)) {
+                reject("Required key '" + rule.key + "' is missing", last);
+            }
+        }
+    }
+
+    static unsigned schemaType(const boost::any& value) {
+        if (value.type() == typeid(std::string)) {
+            return Schema::String;
+        }
+        if (value.type() == typeid(int)) {
+            return Schema::Int;
+        }
+        return value.type() == typeid(Mapping) ? Schema::Map : 0;
+    }
+
+    // Leaves the document empty, as a rejected document is, and raises.
+    void reject(const std::string& reason, const char* at) {
+        SourcePosition position(sourcePosition(input_first, at));
+        reset();
+        raiseError(ValidationException(reason, position.line, position.column));
+    }
+
+    // Keys arrive in input order, so lines are counted on from the last
+    // recorded key and recording costs one pass over the input in total.
+    // A key the grammar backtracks to is located from the start.
+    SourcePosition locate(const char* at) {
+        if (at < position_mark) {
+            return sourcePosition(input_first, at);
+        }
+        position_line += countNewlines(position_mark, at);
+        position_mark = at;
+        const char* start = at;
+        while (start != input_first && start[-1] != '\n') {
+            start--;
+        }
+        return SourcePosition(position_line, at - start + 1);
+    }
+
+    // The list is constructed in place inside its map node, and items are
+    // moved into it, so that building a list never copies one.
+    List& getOrCreateList() {
+        std::map<std::string, boost::any>::iterator current(values.find(current_id));
+        if (current != values.end() && current->second.type() == typeid(List)) {
+            return boost::any_cast<List&>(current->second);
+        }
+        checkDepth(2);
+        countNode(0);
+        timeStamp(current_id);
+        list_key = current_id;
+        boost::any& list = node(current_id, spare_lists);
+        if (list.type() != typeid(List)) {
+            list = List();
+        }
+        boost::any_cast<List&>(list).clear();
+        return boost::any_cast<List&>(list);
+    }
+
+    static void timeStamp(std::string& stamp) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "list-%ld", static_cast<long>(::time(NULL)));
+        stamp.assign(buffer);
+    }
+
+    // Builds a Mapping from the events of scanFlowMapping. Values are stored
+    // as they would be in block context; a << key merges the mapping it
+    // names. The root mapping is a value at depth, and its entries are one
+    // level deeper.
+    class FlowBuilder {
+    public:
+        FlowBuilder(Document& document, boost::any& root, size_t depth) : document(document), root(root), depth(depth), mappings(), key_text() {}
+
+        void open() {
+            document.checkDepth(depth + mappings.size() + 1);
+            if (!mappings.empty()) {
+                document.countNode(key_text.size());
+            }
+            boost::any* slot = &root;
+            if (!mappings.empty() && key_text == "<<") {
+                boost::shared_ptr<boost::any> base(boost::make_shared<boost::any>());
+                mappings.back()->merge(base);
+                slot = base.get();
+            } else if (!mappings.empty()) {
+                slot = &(*mappings.back())[key_text];
+            }
+            *slot = Mapping();
+            mappings.push_back(&boost::any_cast<Mapping&>(*slot));
+        }
+
+        void close() {mappings.pop_back();}
+
+        void key(const char* start, const char* end) {
+            document.checkLength(start, end);
+            scalarText(start, end, key_text);
+        }
+
+        void scalar(const char* start, const char* end) {
+            document.checkLength(start, end);
+            document.countNode(key_text.size() + (end - start));
+            Mapping& mapping = *mappings.back();
+            if (key_text == "<<") {
+                mapping.merge(document.mergeTarget(start, end));
+                return;
+            }
+            boost::any& value = mapping[key_text];
+            if (isAlias(start, end)) {
+                value = Alias(document.aliasTarget(start, end));
+            } else if (isFlowNumber(start, end)) {
+                value = static_cast<int>(strtol(start, NULL, 10));
+            } else {
+                assign(value, start, end);
+            }
+        }
+
+    private:
+        FlowBuilder(const FlowBuilder&);
+        FlowBuilder& operator=(const FlowBuilder&);
+
+    private:
+        Document& document;
+        boost::any& root;
+        size_t depth;
+        std::vector<Mapping*> mappings;
+        std::string key_text;
+    };
+
+    // Estimated size of a value's node, without what its key and text hold.
+    static const size_t nodeBytes = sizeof(std::pair<const std::string, boost::any>) + 4 * sizeof(void*);
+
+    // Clears a pointer to per-parse state when the parse is left, whether it
+    // returns or raises an error.
+    template<class T>
+    struct ClearOnExit {
+        explicit ClearOnExit(T*& pointer) : pointer(pointer) {}
+        ~ClearOnExit() {pointer = 0;}
+
+        T*& pointer;
+    };
+
+    // Moves an anchor table into another document for as long as it lives.
+    struct AnchorLoan {
+        typedef std::map<std::string, boost::shared_ptr<boost::any> > Anchors;
+
+        AnchorLoan(Anchors& owner, Anchors& borrower) : owner(owner), borrower(borrower) {borrower.swap(owner);}
+        ~AnchorLoan() {owner.swap(borrower);}
+
+        Anchors& owner;
+        Anchors& borrower;
+    };
+
+    // Binds the grammar callbacks to the document that owns them.
+    struct Grammar {
+        explicit Grammar(Document* document)
+        : id_f(boost::bind(&Document::id, document, boost::placeholders::_1, boost::placeholders::_2)),
+        value_f(boost::bind(&Document::value, document, boost::placeholders::_1, boost::placeholders::_2)),
+        num_value_f(boost::bind(&Document::num_value, document, boost::placeholders::_1, boost::placeholders::_2)),
+        list_item_f(boost::bind(&Document::list_item, document, boost::placeholders::_1, boost::placeholders::_2)),
+        anchor_f(boost::bind(&Document::anchor, document, boost::placeholders::_1, boost::placeholders::_2)),
+        comment_f(boost::bind(&Document::comment_text, document, boost::placeholders::_1, boost::placeholders::_2)),
+        grammar(id_f, value_f, num_value_f, list_item_f, anchor_f) {
+        }
+
+        grammar_cb id_f;
+        grammar_cb value_f;
+        grammar_cb num_value_f;
+        grammar_cb list_item_f;
+        grammar_cb anchor_f;
+        grammar_cb comment_f;
+        YamlGrammar grammar;
+    };
+
+private:
+    std::map<std::string, boost::any> values;
+    mutable boost::uint64_t hash_value;
+    std::string current_id;
+    std::string list_key;
+    bool redefined_keys;
+    bool collect_stats;
+    ParseStats parse_stats;
+    ParseStats* active_stats;
+    bool keep_comments;
+    std::map<std::string, std::string> comments;
+    std::string pending_comment;
+    const char* last_comment;
+    std::map<std::string, boost::shared_ptr<boost::any> > anchors;
+    MergeOverlay merges;
+    std::string pending_anchor;
+    std::string alias_name;
+    ParseLimits limits;
+    const ParseLimits* active_limits;
+    size_t alias_count;
+    size_t node_count;
+    size_t byte_count;
+    const CancellationToken* active_token;
+    const progress_cb* active_progress;
+    size_t progress_interval;
+    const char* progress_first;
+    const char* next_checkpoint;
+    const CompiledSchema* active_schema;
+    const CompiledSchema::Rule* current_rule;
+    std::vector<char> schema_seen;
+    const char* input_first;
+    size_t stream_offset;
+    size_t stream_lines;
+    long stream_live;
+    ParseError parse_error;
+    bool record_positions;
+    std::map<std::string, SourcePosition> positions;
+    const char* position_mark;
+    size_t position_line;
+    std::vector<Node> spare_nodes;
+    std::vector<Node> spare_lists;
+    std::unique_ptr<Grammar> cached_grammar;
+};
+
+#endif
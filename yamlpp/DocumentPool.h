@@ -0,0 +1,73 @@
+#ifndef YAMLPP_DOCUMENTPOOL_H
+#define YAMLPP_DOCUMENTPOOL_H
+
+#include "Document.h"
+#include <vector>
+
+// Keeps reset documents for reuse so that parsing a stream of similar
+// messages settles into not allocating. A pool is not thread safe; use
+// local() for a pool per thread.
+class DocumentPool {
+public:
+    explicit DocumentPool(size_t capacity = 16) : capacity(capacity), documents() {}
+
+    ~DocumentPool() {
+        for (std::vector<Document*>::iterator it = documents.begin(); it != documents.end(); it++) {
+            delete *it;
+        }
+    }
+
+    static DocumentPool& local() {
+        static thread_local DocumentPool pool;
+        return pool;
+    }
+
+    Document* acquire() {
+        if (documents.empty()) {
+            return new Document();
+        }
+        Document* document = documents.back();
+        documents.pop_back();
+        return document;
+    }
+
+    // Documents beyond the pool's capacity are deleted.
+    void release(Document* document) {
+        if (documents.size() < capacity) {
+            document->reset();
+            documents.push_back(document);
+        } else {
+            delete document;
+        }
+    }
+
+    size_t size() const {return documents.size();}
+
+private:
+    DocumentPool(const DocumentPool&);
+    DocumentPool& operator=(const DocumentPool&);
+
+private:
+    size_t capacity;
+    std::vector<Document*> documents;
+};
+
+// Returns its document to the pool when it goes out of scope.
+class PooledDocument {
+public:
+    explicit PooledDocument(DocumentPool& pool = DocumentPool::local()) : pool(pool), document(pool.acquire()) {}
+    ~PooledDocument() {pool.release(document);}
+
+    Document& operator*() const {return *document;}
+    Document* operator->() const {return document;}
+
+private:
+    PooledDocument(const PooledDocument&);
+    PooledDocument& operator=(const PooledDocument&);
+
+private:
+    DocumentPool& pool;
+    Document* document;
+};
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef YAMLPP_EMITTER_H
+#define YAMLPP_EMITTER_H
+
+#include "Document.h"
+#include <cstring>
+#include <vector>
+
+// Writes a document back as text that parses into the same document.
+// Top level keys and list items are always written one per line, since a
+// document is read line by line, and nested mappings in flow style, the
+// only form the grammar reads for them. Block writes kept comments above
+// their keys; Flow leaves them out.
+class Emitter {
+public:
+    enum Style {Block, Flow};
+
+    explicit Emitter(Style style = Block) : style(style) {}
+
+    std::string emit(const Document& document) const {
+        std::string out;
+        emit(document, out);
+        return out;
+    }
+
+    // Appends the document to out. The output size is estimated up front and
+    // reserved so that the buffer normally grows only once per document.
+    void emit(const Document& document, std::string& out) const {
+        out.reserve(out.size() + estimate(document));
+        std::vector<const List*> lists;
+        for (Document::const_iterator it = document.begin(); it != document.end(); it++) {
+            if (it->second.empty()) {
+                continue;
+            }
+            if (it->second.type() == typeid(List)) {
+                lists.push_back(&boost::any_cast<const List&>(it->second));
+                continue;
+            }
+            if (style == Block) {
+                writeComment(document.comment(it->first), out);
+            }
+            writeProperty(it->first, it->second, out);
+        }
+        document.forEachMerged([&](const std::string& key, const boost::any& value) {
+            writeProperty(key, value, out);
+        });
+        for (std::vector<const List*>::const_iterator it = lists.begin(); it != lists.end(); it++) {
+            writeList(**it, out);
+        }
+    }
+
+    // True when a string cannot be written as a plain scalar because it
+    // would not parse back as the same string. Plain values are letters
+    // only, ASCII or not, and plain keys letters and digits, so anything
+    // else is quoted.
+    static bool needsQuotes(const std::string& value, bool key = false) {
+        if (value.empty()) {
+            return true;
+        }
+        const unsigned char* table = quotingTable();
+        const unsigned char unsafe = key ? UnsafeInKey : Unsafe;
+        for (std::string::const_iterator it = value.begin(); it != value.end(); it++) {
+            if (table[static_cast<unsigned char>(*it)] & unsafe) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void writeInt(int value, std::string& out) {
+        static const char digits[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        char buffer[12];
+        char* end = buffer + sizeof(buffer);
+        char* p = end;
+        unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+        while (magnitude >= 100) {
+            unsigned int pair = (magnitude % 100) * 2;
+            magnitude /= 100;
+            *--p = digits[pair + 1];
+            *--p = digits[pair];
+        }
+        if (magnitude >= 10) {
+            *--p = digits[magnitude * 2 + 1];
+            *--p = digits[magnitude * 2];
+        } else {
+            *--p = static_cast<char>('0' + magnitude);
+        }
+        if (value < 0) {
+            *--p = '-';
+        }
+        out.append(p, end);
+    }
+
+    static void writeString(const std::string& value, std::string& out, bool key = false) {
+        if (!needsQuotes(value, key)) {
+            out.append(value);
+            return;
+        }
+        static const char hex[] = "0123456789abcdef";
+        out.push_back('"');
+        const char* run = value.data();
+        const char* last = value.data() + value.size();
+        for (const char* p = run; p != last; p++) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out.append(run, p);
+            out.push_back('\\');
+            switch (c) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '\n': out.push_back('n'); break;
+            case '\t': out.push_back('t'); break;
+            default:
+                out.push_back('x');
+                out.push_back(hex[c >> 4]);
+                out.push_back(hex[c & 0xf]);
+            }
+            run = p + 1;
+        }
+        out.append(run, last);
+        out.push_back('"');
+    }
+
+private:
+    enum Quoting {Unsafe = 1, UnsafeInKey = 2};
+
+    // Mirrors the plain scalars of the grammar: ASCII letters, digits in
+    // keys only, and the bytes of multibyte UTF-8 sequences. The table is
+    // built once, by a static initializer, so threads can share it.
+    static const unsigned char* quotingTable() {
+        struct Table {unsigned char bits[256];};
+        static const Table table = [] {
+            Table table = Table();
+            for (int c = 0; c < 0x80; c++) {
+                bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+                bool digit = c >= '0' && c <= '9';
+                table.bits[c] = (letter ? 0 : Unsafe) | (letter || digit ? 0 : UnsafeInKey);
+            }
+            return table;
+        }();
+        return table.bits;
+    }
+
+    static void writeProperty(const std::string& key, const boost::any& value, std::string& out) {
+        writeString(key, out, true);
+        out.append(": ");
+        writeScalar(value, out);
+        out.push_back('\n');
+    }
+
+    // Mappings are always written in flow style, merged entries included.
+    static void writeMapping(const Mapping& mapping, std::string& out) {
+        out.push_back('{');
+        bool first = true;
+        mapping.forEach([&](const std::string& key, const boost::any& value) {
+            out.append(first ? "" : ", ");
+            writeString(key, out, true);
+            out.append(": ");
+            writeScalar(value, out);
+            first = false;
+        });
+        out.push_back('}');
+    }
+
+    static void writeScalar(const boost::any& item, std::string& out) {
+        const boost::any& value = resolve(item);
+        if (value.type() == typeid(std::string)) {
+            writeString(boost::any_cast<const std::string&>(value), out);
+        } else if (value.type() == typeid(int)) {
+            writeInt(boost::any_cast<int>(value), out);
+        } else if (value.type() == typeid(Mapping)) {
+            writeMapping(boost::any_cast<const Mapping&>(value), out);
+        } else {
+            raiseError(std::runtime_error(std::string("Cannot emit value of type ") + value.type().name()));
+        }
+    }
+
+    // Writes each line of a kept comment as a comment line of its own.
+    static void writeComment(const std::string& comment, std::string& out) {
+        for (size_t start = 0; start < comment.size();) {
+            size_t end = comment.find('\n', start);
+            if (end == std::string::npos) {
+                end = comment.size();
+            }
+            out.push_back('#');
+            out.append(comment, start, end - start);
+            out.push_back('\n');
+            start = end + 1;
+        }
+    }
+
+    static void writeList(const List& list, std::string& out) {
+        for (size_t i = 0; i < list.count(); i++) {
+            out.append("- ");
+            writeScalar(list[i], out);
+            out.push_back('\n');
+        }
+    }
+
+    static size_t estimate(const boost::any& item) {
+        const boost::any& value = resolve(item);
+        if (value.type() == typeid(std::string)) {
+            return boost::any_cast<const std::string&>(value).size() + 2;
+        }
+        if (value.type() == typeid(List)) {
+            const List& list = boost::any_cast<const List&>(value);
+            size_t size = 0;
+            for (size_t i = 0; i < list.count(); i++) {
+                size += estimate(list[i]) + 3;
+            }
+            return size;
+        }
+        return 11;
+    }
+
+    static size_t estimate(const Document& document) {
+        size_t size = 2;
+        for (Document::const_iterator it = document.begin(); it != document.end(); it++) {
+            size += it->first.size() + estimate(it->second) + 4;
+        }
+        return size;
+    }
+
+private:
+    Style style;
+};
+
+#endif
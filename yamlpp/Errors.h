@@ -0,0 +1,59 @@
+#ifndef YAMLPP_ERRORS_H
+#define YAMLPP_ERRORS_H
+
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+// Every error in the library is raised through raiseError, which normally
+// throws it. For builds with -fno-exceptions, define YAMLPP_NO_EXCEPTIONS
+// in every translation unit: raiseError then passes the error's message to
+// the handler set with setErrorHandler and aborts. Code that must not abort
+// should use the non-throwing accessors such as Document::tryGet.
+//
+// Boost reports its own errors through boost::throw_exception, which the
+// program has to define when BOOST_NO_EXCEPTIONS is set. Defining
+// YAMLPP_DEFINE_THROW_EXCEPTION as well in exactly one translation unit,
+// before any yamlpp header is included, defines it to report through the
+// same handler.
+typedef void (*ErrorHandler)(const char* message);
+
+inline ErrorHandler& errorHandler() {
+    static ErrorHandler handler = 0;
+    return handler;
+}
+
+inline void setErrorHandler(ErrorHandler handler) {
+    errorHandler() = handler;
+}
+
+inline const char* errorMessage(const std::exception& error) {return error.what();}
+inline const char* errorMessage(const std::string& error) {return error.c_str();}
+
+template<class E>
+[[noreturn]] void raiseError(const E& error) {
+#ifdef YAMLPP_NO_EXCEPTIONS
+    if (ErrorHandler handler = errorHandler()) {
+        handler(errorMessage(error));
+    }
+    std::abort();
+#else
+    throw error;
+#endif
+}
+
+#if defined(YAMLPP_NO_EXCEPTIONS) && defined(YAMLPP_DEFINE_THROW_EXCEPTION)
+#include <boost/assert/source_location.hpp>
+
+namespace boost {
+    void throw_exception(const std::exception& error) {
+        raiseError(error);
+    }
+
+    void throw_exception(const std::exception& error, const boost::source_location&) {
+        raiseError(error);
+    }
+}
+#endif
+
+#endif
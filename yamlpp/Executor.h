@@ -0,0 +1,239 @@
+#ifndef YAMLPP_EXECUTOR_H
+#define YAMLPP_EXECUTOR_H
+
+#include <boost/function.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+
+// A piece of parallel work and the number of bytes it covers, by which
+// executors balance their threads.
+struct SizedTask {
+    SizedTask() : work(), bytes(0) {}
+    SizedTask(const boost::function0<void>& work, size_t bytes) : work(work), bytes(bytes) {}
+
+    boost::function0<void> work;
+    size_t bytes;
+};
+
+// Runs the tasks of the parallel parsing APIs. Implement it to run them on
+// a scheduler of your own and pass it to those APIs, or install it with
+// setDefaultExecutor.
+class Executor {
+public:
+    virtual ~Executor() {}
+
+    // Runs every task, in any order and on any thread, and returns once all
+    // of them have finished. If tasks raise errors, the first one is raised
+    // again after the rest have finished.
+    virtual void run(const std::vector<SizedTask>& tasks) = 0;
+};
+
+// Runs tasks one after another on the calling thread.
+class InlineExecutor : public Executor {
+public:
+    void run(const std::vector<SizedTask>& tasks) {
+        for (size_t i = 0; i < tasks.size(); i++) {
+            tasks[i].work();
+        }
+    }
+};
+
+// A pool of threads with a deque of tasks each. A batch is dealt out
+// largest task first, each to the thread with the fewest bytes so far, so
+// that a few large inputs do not end up queued behind each other. A thread
+// takes tasks from the front of its own deque and, once that is empty,
+// steals from the back of the others'. The thread that runs a batch helps
+// with it until it is done. Threads can be pinned to CPUs, one each in
+// turn.
+//
+// run() may be called from several threads, which take turns, but not from
+// within a task.
+class WorkStealingPool : public Executor {
+public:
+    explicit WorkStealingPool(size_t threads = defaultThreads(), bool pin = false)
+    : queues(), workers(), lock(), wake(), finished(), running(), queued(0), remaining(0), stopping(false), failure() {
+        threads = std::max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; i++) {
+            queues.push_back(std::unique_ptr<Queue>(new Queue()));
+        }
+        for (size_t i = 0; i < threads; i++) {
+            workers.push_back(std::thread(&WorkStealingPool::work, this, i, pin));
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+    }
+
+    static size_t defaultThreads() {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    size_t size() const {return workers.size();}
+
+    void run(const std::vector<SizedTask>& tasks) {
+        if (tasks.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> turn(running);
+        std::vector<const SizedTask*> order;
+        order.reserve(tasks.size());
+        for (size_t i = 0; i < tasks.size(); i++) {
+            order.push_back(&tasks[i]);
+        }
+        std::stable_sort(order.begin(), order.end(), [](const SizedTask* a, const SizedTask* b) {return a->bytes > b->bytes;});
+        std::vector<size_t> load(queues.size(), 0);
+        remaining = tasks.size();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queued += tasks.size();
+        }
+        for (size_t i = 0; i < order.size(); i++) {
+            size_t least = std::min_element(load.begin(), load.end()) - load.begin();
+            load[least] += order[i]->bytes;
+            std::lock_guard<std::mutex> guard(queues[least]->lock);
+            queues[least]->tasks.push_back(order[i]);
+        }
+        wake.notify_all();
+        while (runOne(queues.size())) {
+        }
+        std::unique_lock<std::mutex> guard(lock);
+        finished.wait(guard, [this] {return remaining == 0;});
+        if (failure) {
+            std::exception_ptr error(failure);
+            failure = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex lock;
+        std::deque<const SizedTask*> tasks;
+    };
+
+    void work(size_t index, bool pin) {
+        if (pin) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(index % std::max(std::thread::hardware_concurrency(), 1u), &cpus);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+        for (;;) {
+            if (runOne(index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this] {return stopping || queued > 0;});
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+    // Runs a task from queue index, or stolen from another queue. The
+    // thread running a batch has no queue of its own and only steals.
+    bool runOne(size_t index) {
+        const SizedTask* task = take(index);
+        if (!task) {
+            return false;
+        }
+#ifdef YAMLPP_NO_EXCEPTIONS
+        task->work();
+#else
+        try {
+            task->work();
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+#endif
+        if (--remaining == 0) {
+            std::lock_guard<std::mutex> guard(lock);
+            finished.notify_all();
+        }
+        return true;
+    }
+
+    const SizedTask* take(size_t index) {
+        for (size_t i = 0; i <= queues.size(); i++) {
+            size_t victim = (index + i) % (queues.size() + 1);
+            if (victim == queues.size()) {
+                continue;
+            }
+            Queue& queue = *queues[victim];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            const SizedTask* task;
+            if (victim == index) {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            } else {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            queued--;
+            return task;
+        }
+        return 0;
+    }
+
+private:
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator=(const WorkStealingPool&);
+
+private:
+    std::vector<std::unique_ptr<Queue> > queues;
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::mutex running;
+    std::atomic<size_t> queued;
+    std::atomic<size_t> remaining;
+    bool stopping;
+    std::exception_ptr failure;
+};
+
+inline Executor*& installedExecutor() {
+    static Executor* executor = 0;
+    return executor;
+}
+
+// Replaces the executor the parallel APIs use when none is given. Pass null
+// to go back to the built-in pool.
+inline void setDefaultExecutor(Executor* executor) {
+    installedExecutor() = executor;
+}
+
+// The installed executor, or a pool with a thread per CPU that is started
+// on first use.
+inline Executor& defaultExecutor() {
+    if (Executor* executor = installedExecutor()) {
+        return *executor;
+    }
+    static WorkStealingPool pool;
+    return pool;
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef YAMLPP_FILELOADER_H
+#define YAMLPP_FILELOADER_H
+
+#include "Document.h"
+#include "Executor.h"
+#include <boost/function.hpp>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A file loaded by loadAll. When the file could not be read or parsed,
+// error says why and the document holds whatever was parsed before the
+// error.
+struct LoadedDocument {
+    LoadedDocument() : path(), document(), error() {}
+
+    bool ok() const {return error.empty();}
+
+    std::string path;
+    Document document;
+    std::string error;
+};
+
+typedef boost::function1<void, LoadedDocument&> loaded_cb;
+
+// Reads and parses files on an executor, a task per file sized by the
+// file's length. Each task reads a whole file with pread into a buffer its
+// thread keeps for the next file, then parses it, so reads and parses of
+// different files overlap and a thread settles into not allocating for its
+// buffer. A buffer that grew past keptBuffer for a large file is freed
+// once the file is parsed, so that one large file does not hold memory in
+// every thread that met one.
+class FileLoader {
+public:
+    static const size_t keptBuffer = 4 * 1024 * 1024;
+
+    explicit FileLoader(Executor& executor = defaultExecutor()) : executor(executor) {}
+
+    // Calls done for every file as soon as it has been parsed, in no
+    // particular order. done is called from the loading threads, but never
+    // by two at a time; it may move the document out.
+    void loadAll(const std::vector<std::string>& paths, const loaded_cb& done) const {
+        std::mutex lock;
+        std::vector<SizedTask> tasks;
+        tasks.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            tasks.push_back(SizedTask([&paths, &done, &lock, i] {
+                LoadedDocument loaded;
+                load(paths[i], loaded);
+                std::lock_guard<std::mutex> guard(lock);
+                done(loaded);
+            }, fileSize(paths[i])));
+        }
+        executor.run(tasks);
+    }
+
+    // Returns the loaded files in the order of paths.
+    std::vector<LoadedDocument> loadAll(const std::vector<std::string>& paths) const {
+        std::vector<LoadedDocument> loaded(paths.size());
+        std::vector<SizedTask> tasks;
+        tasks.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            tasks.push_back(SizedTask([&paths, &loaded, i] {load(paths[i], loaded[i]);}, fileSize(paths[i])));
+        }
+        executor.run(tasks);
+        return loaded;
+    }
+
+    // Reads the whole file at path into buffer. Returns false and sets
+    // errno if it cannot be read.
+    static bool readFile(const std::string& path, std::string& buffer) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        bool read = ::fstat(fd, &info) == 0;
+        if (read) {
+            buffer.resize(info.st_size);
+            size_t done = 0;
+            while (done < buffer.size()) {
+                ssize_t count = ::pread(fd, &buffer[done], buffer.size() - done, done);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    read = count == 0;
+                    break;
+                }
+                done += count;
+            }
+            buffer.resize(done);
+        }
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        return read;
+    }
+
+private:
+    static size_t fileSize(const std::string& path) {
+        struct stat info;
+        return ::stat(path.c_str(), &info) == 0 ? info.st_size : 0;
+    }
+
+    static void load(const std::string& path, LoadedDocument& loaded) {
+        static thread_local std::string buffer;
+        loaded.path = path;
+        if (!readFile(path, buffer)) {
+            loaded.error = "Cannot read " + path + ": " + std::strerror(errno);
+        } else {
+#ifdef YAMLPP_NO_EXCEPTIONS
+            parse(buffer, loaded);
+#else
+            try {
+                parse(buffer, loaded);
+            } catch (const std::exception& error) {
+                loaded.error = error.what();
+            }
+#endif
+        }
+        if (buffer.capacity() > keptBuffer) {
+            std::string().swap(buffer);
+        }
+    }
+
+    // The error message is made while the buffer it points into is alive.
+    static void parse(const std::string& buffer, LoadedDocument& loaded) {
+        if (!loaded.document.parse(buffer).full) {
+            loaded.error = loaded.document.error().message();
+        }
+    }
+
+private:
+    Executor& executor;
+};
+
+#endif
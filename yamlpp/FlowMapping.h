@@ -0,0 +1,151 @@
+#ifndef YAMLPP_FLOWMAPPING_H
+#define YAMLPP_FLOWMAPPING_H
+
+#include <boost/spirit.hpp>
+#include <cctype>
+#include "Quoted.h"
+#include "Skipper.h"
+
+// Returns the end of the scalar starting at p inside a flow mapping. Quoted
+// scalars end after their closing quote; plain ones before the , or } that
+// ends them, or for keys before the ': ' that follows them. Trailing
+// whitespace is not part of a plain scalar.
+inline const char* flowScalarEnd(const char* p, const char* last, bool key) {
+    if (*p == '"' || *p == '\'') {
+        const char* closing = findClosingQuote(p, last);
+        return closing == last ? 0 : closing + 1;
+    }
+    const char* end = p;
+    for (const char* q = p; q != last && *q != ',' && *q != '}' && *q != '{' && *q != '\n'; q++) {
+        if (key && *q == ':' && (q + 1 == last || q[1] == ' ' || q[1] == ',' || q[1] == '}')) {
+            break;
+        }
+        if (*q != ' ' && *q != '\t' && *q != '\r') {
+            end = q + 1;
+        }
+    }
+    return end == p ? 0 : end;
+}
+
+// True when a plain flow scalar is a number, as real_p would match it in
+// block context: decimal digits with an optional sign, fraction and
+// exponent. Hex, inf and nan are left as strings, as they are in block
+// context, rather than read by strtol as 0.
+inline bool isFlowNumber(const char* first, const char* last) {
+    const char* p = first;
+    if (p != last && (*p == '-' || *p == '+')) {
+        p++;
+    }
+    size_t digits = 0;
+    for (; p != last && std::isdigit(static_cast<unsigned char>(*p)); p++) {
+        digits++;
+    }
+    if (p != last && *p == '.') {
+        for (p++; p != last && std::isdigit(static_cast<unsigned char>(*p)); p++) {
+            digits++;
+        }
+    }
+    if (!digits) {
+        return false;
+    }
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p != last && (*p == '-' || *p == '+')) {
+            p++;
+        }
+        if (p == last || !std::isdigit(static_cast<unsigned char>(*p))) {
+            return false;
+        }
+        while (p != last && std::isdigit(static_cast<unsigned char>(*p))) {
+            p++;
+        }
+    }
+    return p == last;
+}
+
+// Mappings nested deeper than this are treated as malformed, so that a
+// hostile document cannot exhaust the stack of the recursive scan.
+const size_t flowMappingDepthLimit = 512;
+
+// Scans the flow mapping opened at p and reports it to handler: open() and
+// close() for every mapping, key() for every key and scalar() for every
+// value that is not a mapping. Scalars are reported as they are written,
+// quotes and * included. Returns the end of the mapping, or 0 if it is
+// malformed.
+template<class Handler>
+const char* scanFlowMapping(const char* p, const char* last, Handler& handler, size_t depth = 1) {
+    if (depth > flowMappingDepthLimit) {
+        return 0;
+    }
+    handler.open();
+    p = skipBlank(p + 1, last);
+    while (p != last && *p != '}') {
+        const char* keyEnd = flowScalarEnd(p, last, true);
+        if (!keyEnd) {
+            return 0;
+        }
+        handler.key(p, keyEnd);
+        p = skipBlank(keyEnd, last);
+        if (p == last || *p != ':') {
+            return 0;
+        }
+        p = skipBlank(p + 1, last);
+        if (p != last && *p == '{') {
+            p = scanFlowMapping(p, last, handler, depth + 1);
+        } else {
+            const char* valueEnd = p == last ? 0 : flowScalarEnd(p, last, false);
+            if (valueEnd) {
+                handler.scalar(p, valueEnd);
+            }
+            p = valueEnd;
+        }
+        if (!p) {
+            return 0;
+        }
+        p = skipBlank(p, last);
+        if (p != last && *p == ',') {
+            p = skipBlank(p + 1, last);
+        } else if (p == last || *p != '}') {
+            return 0;
+        }
+    }
+    if (p == last) {
+        return 0;
+    }
+    handler.close();
+    return p + 1;
+}
+
+struct IgnoreFlowMapping {
+    void open() {}
+    void close() {}
+    void key(const char*, const char*) {}
+    void scalar(const char*, const char*) {}
+};
+
+inline bool isFlowMapping(const char* first, const char* last) {
+    return first != last && *first == '{';
+}
+
+// Spirit parser for a flow mapping, braces included. Like all functor
+// parsers it advances the scanner itself.
+struct FlowMapping {
+    typedef boost::spirit::nil_t result_t;
+
+    template<class ScannerT>
+    std::ptrdiff_t operator()(const ScannerT& scan, result_t&) const {
+        if (scan.at_end() || *scan != '{') {
+            return -1;
+        }
+        const char* first = scan.first;
+        IgnoreFlowMapping ignore;
+        const char* end = scanFlowMapping(first, scan.last, ignore);
+        if (!end) {
+            return -1;
+        }
+        scan.first = end;
+        return end - first;
+    }
+};
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef YAMLPP_JSONTRANSCODER_H
+#define YAMLPP_JSONTRANSCODER_H
+
+#include "Document.h"
+#include <ostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+// Writes JSON straight from the grammar callbacks without building a
+// Document, so memory use does not depend on the size of the input.
+class JsonTranscoder {
+public:
+    explicit JsonTranscoder(std::ostream& out) : out(out), state(Empty), key_start(0), key_end(0), decoded(), anchors(), pending_anchor(),
+    alias_name(), alias_limit(Document::defaultAliasLimit), alias_count(0) {}
+
+    // Caps the number of aliases written out, as Document::aliasLimit does.
+    void aliasLimit(size_t limit) {alias_limit = limit;}
+
+    parse_info<> transcode(const std::string& data) {
+        return transcode(data.c_str(), data.c_str() + data.size());
+    }
+
+    // Invalid UTF-8 fails the transcoding at the offending byte before
+    // anything is written.
+    parse_info<> transcode(const char* first, const char* last) {
+        const char* invalid = validateUtf8(first, last);
+        if (invalid != last) {
+            return parse_info<>(invalid, false, false, 0);
+        }
+        state = Empty;
+        anchors.clear();
+        pending_anchor.clear();
+        alias_count = 0;
+        grammar_cb id_f(boost::bind(&JsonTranscoder::id, this, boost::placeholders::_1, boost::placeholders::_2));
+        grammar_cb value_f(boost::bind(&JsonTranscoder::value, this, boost::placeholders::_1, boost::placeholders::_2));
+        grammar_cb num_value_f(boost::bind(&JsonTranscoder::num_value, this, boost::placeholders::_1, boost::placeholders::_2));
+        grammar_cb list_item_f(boost::bind(&JsonTranscoder::list_item, this, boost::placeholders::_1, boost::placeholders::_2));
+        grammar_cb anchor_f(boost::bind(&JsonTranscoder::anchor, this, boost::placeholders::_1, boost::placeholders::_2));
+        YamlGrammar grammar(id_f, value_f, num_value_f, list_item_f, anchor_f);
+        parse_info<> info = skipTrailingBlank(boost::spirit::parse(first, last, grammar >> eps_p, functor_parser<Skipper>()), last);
+        switch (state) {
+        case Empty: out.write("{}", 2); break;
+        case Object: out.put('}'); break;
+        case Array: out.put(']'); break;
+        }
+        return info;
+    }
+
+private:
+    enum State {Empty, Object, Array};
+
+    // Anchored scalars are remembered by their place in the input and
+    // written again for each alias to them.
+    struct Anchored {
+        Anchored() : start(0), end(0), number(false) {}
+        Anchored(const char* start, const char* end, bool number) : start(start), end(end), number(number) {}
+
+        const char* start;
+        const char* end;
+        bool number;
+    };
+
+    // The key is written only once its value has been matched, so that a
+    // property the grammar backtracks out of leaves no trace in the output.
+    void id(const char* start, const char* end) {
+        key_start = start;
+        key_end = end;
+    }
+
+    void value(const char* start, const char* end) {
+        writeKey();
+        writeValue(start, end, false);
+    }
+
+    void num_value(const char* start, const char* end) {
+        writeKey();
+        writeValue(start, end, true);
+    }
+
+    void list_item(const char* start, const char* end) {
+        open(Array);
+        writeValue(start, end, false);
+    }
+
+    void anchor(const char* start, const char* end) {
+        pending_anchor.assign(start, end);
+    }
+
+    void writeValue(const char* start, const char* end, bool number) {
+        if (key_end - key_start == 2 && std::memcmp(key_start, "<<", 2) == 0) {
+            raiseError(std::runtime_error("Cannot write merge keys in JSON output"));
+        }
+        if (isAlias(start, end)) {
+            const Anchored& anchored = lookup(start, end);
+            start = anchored.start;
+            end = anchored.end;
+            number = anchored.number;
+        } else if (!pending_anchor.empty()) {
+            anchors[pending_anchor] = Anchored(start, end, number);
+            pending_anchor.clear();
+        }
+        if (number) {
+            out << static_cast<int>(strtol(start, NULL, 10));
+        } else if (isFlowMapping(start, end)) {
+            FlowWriter writer(*this);
+            scanFlowMapping(start, end, writer);
+        } else {
+            writeScalar(start, end);
+        }
+    }
+
+    // Writes a flow mapping as a JSON object from the events of
+    // scanFlowMapping.
+    class FlowWriter {
+    public:
+        explicit FlowWriter(JsonTranscoder& transcoder) : transcoder(transcoder), first(true) {}
+
+        void open() {
+            transcoder.out.put('{');
+            first = true;
+        }
+
+        void close() {
+            transcoder.out.put('}');
+            first = false;
+        }
+
+        void key(const char* start, const char* end) {
+            if (end - start == 2 && std::memcmp(start, "<<", 2) == 0) {
+                raiseError(std::runtime_error("Cannot write merge keys in JSON output"));
+            }
+            if (!first) {
+                transcoder.out.put(',');
+            }
+            transcoder.writeScalar(start, end);
+            transcoder.out.put(':');
+            first = false;
+        }
+
+        void scalar(const char* start, const char* end) {
+            transcoder.writeValue(start, end, isFlowNumber(start, end));
+        }
+
+    private:
+        JsonTranscoder& transcoder;
+        bool first;
+    };
+
+    const Anchored& lookup(const char* start, const char* end) {
+        if (++alias_count > alias_limit) {
+            raiseError(AliasLimitException(alias_limit));
+        }
+        alias_name.assign(start + 1, end);
+        std::map<std::string, Anchored>::const_iterator it(anchors.find(alias_name));
+        if (it == anchors.end()) {
+            raiseError(UnknownAliasException(alias_name));
+        }
+        pending_anchor.clear();
+        return it->second;
+    }
+
+    void writeKey() {
+        open(Object);
+        writeScalar(key_start, key_end);
+        out.put(':');
+    }
+
+    void open(State kind) {
+        if (state == kind) {
+            out.put(',');
+        } else if (state == Empty) {
+            out.put(kind == Object ? '{' : '[');
+            state = kind;
+        } else {
+            raiseError(std::runtime_error("Cannot mix mappings and list items in JSON output"));
+        }
+    }
+
+    // Plain and escape free quoted scalars are written straight from the
+    // input; only those with escapes and block scalars are decoded first.
+    void writeScalar(const char* start, const char* end) {
+        if (isBlockScalar(start, end) || (isQuoted(start, end) && findQuoteOrEscape(start + 1, end - 1, *start) != end - 1)) {
+            scalarText(start, end, decoded);
+            writeString(decoded.data(), decoded.data() + decoded.size());
+        } else if (isQuoted(start, end)) {
+            writeString(start + 1, end - 1);
+        } else {
+            writeString(start, end);
+        }
+    }
+
+    void writeString(const char* start, const char* end) {
+        static const char hex[] = "0123456789abcdef";
+        const char* const escapes = escapeTable();
+        out.put('"');
+        const char* run = start;
+        for (const char* p = start; p != end; p++) {
+            char escape = escapes[static_cast<unsigned char>(*p)];
+            if (!escape) {
+                continue;
+            }
+            out.write(run, p - run);
+            out.put('\\');
+            out.put(escape);
+            if (escape == 'u') {
+                out.write("00", 2);
+                out.put(hex[(*p >> 4) & 0xf]);
+                out.put(hex[*p & 0xf]);
+            }
+            run = p + 1;
+        }
+        out.write(run, end - run);
+        out.put('"');
+    }
+
+    // Built once, by a static initializer, so threads can share it.
+    static const char* escapeTable() {
+        struct Table {char escapes[256];};
+        static const Table table = [] {
+            Table table = Table();
+            for (int c = 0; c < 0x20; c++) {
+                table.escapes[c] = 'u';
+            }
+            table.escapes[static_cast<unsigned char>('"')] = '"';
+            table.escapes[static_cast<unsigned char>('\\')] = '\\';
+            table.escapes[static_cast<unsigned char>('\b')] = 'b';
+            table.escapes[static_cast<unsigned char>('\f')] = 'f';
+            table.escapes[static_cast<unsigned char>('\n')] = 'n';
+            table.escapes[static_cast<unsigned char>('\r')] = 'r';
+            table.escapes[static_cast<unsigned char>('\t')] = 't';
+            return table;
+        }();
+        return table.escapes;
+    }
+
+private:
+    std::ostream& out;
+    State state;
+    const char* key_start;
+    const char* key_end;
+    std::string decoded;
+    std::map<std::string, Anchored> anchors;
+    std::string pending_anchor;
+    std::string alias_name;
+    size_t alias_limit;
+    size_t alias_count;
+};
+
+#endif
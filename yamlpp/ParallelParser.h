@@ -0,0 +1,173 @@
+#ifndef YAMLPP_PARALLELPARSER_H
+#define YAMLPP_PARALLELPARSER_H
+
+#include "Document.h"
+#include "Executor.h"
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Parses on an executor: the documents of a multi-document stream side by
+// side, or one large document in pieces. Tasks are sized by the bytes they
+// parse.
+class ParallelParser {
+public:
+    typedef std::pair<const char*, const char*> Range;
+
+    static const size_t defaultChunk = 1 << 20;
+
+    explicit ParallelParser(Executor& executor = defaultExecutor()) : executor(executor) {}
+
+    // Parses every document of a stream whose documents are separated by
+    // --- lines, a task per document. A document that fails to parse has
+    // its error() set, which points into stream.
+    std::vector<Document> parseAll(const std::string& stream) const {
+        std::vector<Range> ranges(splitDocuments(stream.c_str(), stream.c_str() + stream.size()));
+        std::vector<Document> documents(ranges.size());
+        std::vector<SizedTask> tasks;
+        tasks.reserve(ranges.size());
+        for (size_t i = 0; i < ranges.size(); i++) {
+            if (skipBlank(ranges[i].first, ranges[i].second) == ranges[i].second) {
+                continue;
+            }
+            Document* document = &documents[i];
+            Range range = ranges[i];
+            tasks.push_back(SizedTask([document, range] {document->parseChunk(range.first, range.second);}, range.second - range.first));
+        }
+        executor.run(tasks);
+        return documents;
+    }
+
+    // Parses data into document in pieces of about chunk bytes, split where
+    // top level lines start, and puts the pieces together in order: later
+    // keys replace earlier ones and list items are appended to the
+    // document's list. Limits apply to the pieces together. Data with anchors,
+    // aliases or merge keys, and documents that keep comments or positions,
+    // are parsed in one piece.
+    //
+    // A line that starts at the left margin may still continue a flow
+    // mapping or a quoted scalar. Splitting there leaves the piece before it
+    // unterminated, so it fails; whenever a piece fails, the data is parsed
+    // again in one piece, which also places the error.
+    parse_info<> parse(const std::string& data, Document& document, size_t chunk = defaultChunk) const {
+        const char* first = data.c_str();
+        const char* last = first + data.size();
+        if (data.size() <= chunk || !splittable(data, document)) {
+            return document.parse(data);
+        }
+        std::vector<Range> ranges(splitLines(first, last, chunk));
+        std::vector<Document> pieces(ranges.size());
+        std::vector<parse_info<> > infos(ranges.size());
+        std::vector<SizedTask> tasks;
+        tasks.reserve(ranges.size());
+        for (size_t i = 0; i < ranges.size(); i++) {
+            pieces[i].parseLimits(document.parseLimits());
+            pieces[i].collect_stats = document.collect_stats;
+            Document* piece = &pieces[i];
+            parse_info<>* info = &infos[i];
+            Range range = ranges[i];
+            tasks.push_back(SizedTask([piece, info, range] {*info = piece->parseChunk(range.first, range.second);}, range.second - range.first));
+        }
+        executor.run(tasks);
+        for (size_t i = 0; i < infos.size(); i++) {
+            if (!infos[i].full) {
+                return document.parse(data);
+            }
+        }
+        document.input_first = first;
+        document.startStream();
+        for (size_t i = 0; i < pieces.size(); i++) {
+            document.countChunk(pieces[i]);
+            absorb(document, pieces[i]);
+        }
+        document.finishStream();
+        document.parse_error = ParseError();
+        return parse_info<>(last, true, true, last - first);
+    }
+
+    // Returns the documents of a stream: the text between --- lines, and
+    // before the first one unless it is blank.
+    static std::vector<Range> splitDocuments(const char* first, const char* last) {
+        std::vector<Range> ranges;
+        const char* start = first;
+        for (const char* line = first; line != last; ) {
+            const char* newline = static_cast<const char*>(std::memchr(line, '\n', last - line));
+            const char* next = newline ? newline + 1 : last;
+            if (isMarker(line, next)) {
+                if (start != first || skipBlank(start, line) != line) {
+                    ranges.push_back(Range(start, line));
+                }
+                start = line + 3;
+            }
+            line = next;
+        }
+        if (start != first || skipBlank(start, last) != last) {
+            ranges.push_back(Range(start, last));
+        }
+        return ranges;
+    }
+
+    // Splits [first, last) into ranges of at least chunk bytes, each ending
+    // where a top level line starts.
+    static std::vector<Range> splitLines(const char* first, const char* last, size_t chunk) {
+        std::vector<Range> ranges;
+        const char* start = first;
+        while (static_cast<size_t>(last - start) > chunk) {
+            const char* end = topLevelLine(start + chunk, last);
+            if (end == last) {
+                break;
+            }
+            ranges.push_back(Range(start, end));
+            start = end;
+        }
+        ranges.push_back(Range(start, last));
+        return ranges;
+    }
+
+private:
+    static bool isMarker(const char* line, const char* next) {
+        return next - line >= 3 && std::memcmp(line, "---", 3) == 0
+            && (line + 3 == next || line[3] == ' ' || line[3] == '\t' || line[3] == '\r' || line[3] == '\n');
+    }
+
+    // Returns the start of the first top level line after p, or last.
+    static const char* topLevelLine(const char* p, const char* last) {
+        for (;;) {
+            const char* newline = static_cast<const char*>(std::memchr(p, '\n', last - p));
+            if (!newline || newline + 1 == last) {
+                return last;
+            }
+            char c = newline[1];
+            if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                return newline + 1;
+            }
+            p = newline + 1;
+        }
+    }
+
+    static bool splittable(const std::string& data, const Document& document) {
+        return !document.keep_comments && !document.record_positions
+            && !std::memchr(data.c_str(), '&', data.size()) && !std::memchr(data.c_str(), '*', data.size())
+            && data.find("<<") == std::string::npos;
+    }
+
+    static void absorb(Document& document, Document& piece) {
+        for (std::map<std::string, boost::any>::iterator it = piece.values.begin(); it != piece.values.end(); it++) {
+            List* items = boost::any_cast<List>(&it->second);
+            List* list = items ? document.findList() : 0;
+            if (list) {
+                list->splice(*items);
+            } else {
+                boost::any& value = document.values[it->first];
+                document.redefined_keys = document.redefined_keys || piece.redefined_keys || !value.empty();
+                value = std::move(it->second);
+            }
+        }
+    }
+
+private:
+    Executor& executor;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef YAMLPP_PARSEERROR_H
+#define YAMLPP_PARSEERROR_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include "Skipper.h"
+#include "Utf8.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Counts the line breaks in [p, last) sixteen bytes at a time.
+inline size_t countNewlines(const char* p, const char* last) {
+    size_t count = 0;
+#ifdef __SSE2__
+    const __m128i newlines = _mm_set1_epi8('\n');
+    while (last - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newlines)));
+        p += 16;
+    }
+#endif
+    for (; p != last; p++) {
+        count += *p == '\n';
+    }
+    return count;
+}
+
+// Line and column of a byte, both counted from one. Columns count bytes.
+struct SourcePosition {
+    SourcePosition() : line(1), column(1) {}
+    SourcePosition(size_t line, size_t column) : line(line), column(column) {}
+
+    size_t line;
+    size_t column;
+};
+
+// Returns the position of at in the input starting at first.
+inline SourcePosition sourcePosition(const char* first, const char* at) {
+    const char* start = at;
+    while (start != first && start[-1] != '\n') {
+        start--;
+    }
+    return SourcePosition(1 + countNewlines(first, start), at - start + 1);
+}
+
+// Describes where and why a parse stopped. It only keeps pointers into the
+// input, so it costs nothing to make and is only valid while the input is;
+// the position and the rest are worked out when asked for. For input parsed
+// in pieces, first is the start of the piece, which begins a line and comes
+// offset bytes and lines line breaks into the whole input.
+class ParseError {
+public:
+    ParseError() : first(0), stop(0), last(0), before(0), lines_before(0), position(), located(false) {}
+    ParseError(const char* first, const char* stop, const char* last, size_t offset = 0, size_t lines = 0)
+    : first(first), stop(stop), last(last), before(offset), lines_before(lines), position(), located(false) {}
+
+    // True when there is no error.
+    bool ok() const {return !stop;}
+
+    // Offset of the first byte that could not be parsed.
+    size_t offset() const {return before + (at() - first);}
+
+    size_t line() const {return lines_before + locate().line;}
+    size_t column() const {return locate().column;}
+
+    // The line the error is on, without its line break.
+    std::string context() const {
+        const char* start = at() - (column() - 1);
+        const char* end = static_cast<const char*>(std::memchr(start, '\n', last - start));
+        return std::string(start, end ? end : last);
+    }
+
+    // What the parser would have accepted at the error.
+    std::string expected() const {
+        const char* p = at();
+        if (p == last) {
+            return "more input";
+        }
+        if (validateUtf8(p, last) == p) {
+            return "valid UTF-8";
+        }
+        if (*p == '-') {
+            return "a list item";
+        }
+        const char* end = static_cast<const char*>(std::memchr(p, '\n', last - p));
+        const char* colon = static_cast<const char*>(std::memchr(p, ':', (end ? end : last) - p));
+        if (!colon) {
+            return "':' after a key";
+        }
+        return "a value after ':'";
+    }
+
+    std::string message() const {
+        if (ok()) {
+            return std::string();
+        }
+        return "Expected " + expected() + " at line " + std::to_string(line()) + ", column " + std::to_string(column()) + ": " + context();
+    }
+
+private:
+    // The grammar stops where the line it could not parse starts, so the
+    // error is at the first byte that is not blank or a comment.
+    const char* at() const {
+        if (!stop) {
+            return first;
+        }
+        const char* p = skipBlank(stop, last);
+        return p == last && stop != last ? stop : p;
+    }
+
+    const SourcePosition& locate() const {
+        if (!located) {
+            position = sourcePosition(first, at());
+            located = true;
+        }
+        return position;
+    }
+
+private:
+    const char* first;
+    const char* stop;
+    const char* last;
+    size_t before;
+    size_t lines_before;
+    mutable SourcePosition position;
+    mutable bool located;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef YAMLPP_PARSELIMITS_H
+#define YAMLPP_PARSELIMITS_H
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+// Caps on what a single parse may build, for documents that cannot be
+// trusted. The defaults leave everything unlimited except aliases. Limits
+// are enforced with counters as values are stored; the clock is read only
+// every few hundred values.
+struct ParseLimits {
+    typedef std::chrono::steady_clock Clock;
+
+    static const size_t unlimited = static_cast<size_t>(-1);
+    static const size_t defaultAliases = 1 << 16;
+
+    ParseLimits() : depth(unlimited), nodes(unlimited), scalar_length(unlimited), bytes(unlimited), aliases(defaultAliases), deadline() {}
+
+    // Nesting of collections: top level values are at depth 1, list items
+    // and the entries of a flow mapping one deeper than what holds them.
+    size_t depth;
+
+    // Values stored, mappings and lists included.
+    size_t nodes;
+
+    // Length of a key or scalar as written in the input, in bytes.
+    size_t scalar_length;
+
+    // Estimated bytes held by the values built, keys and text included.
+    size_t bytes;
+
+    size_t aliases;
+
+    // No deadline when left at its default.
+    Clock::time_point deadline;
+};
+
+// Raised when a parse goes over one of its limits. The document is left
+// empty and the memory it held is released.
+class LimitExceededException : public std::runtime_error {
+public:
+    enum Limit {Depth, Nodes, ScalarLength, Bytes, Deadline, Aliases};
+
+    LimitExceededException(Limit limit, const std::string& message) : std::runtime_error(message), exceeded(limit) {}
+
+    Limit limit() const {return exceeded;}
+
+private:
+    Limit exceeded;
+};
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef YAMLPP_PARSESTATS_H
+#define YAMLPP_PARSESTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include "Errors.h"
+
+// Cost of a single parse, or of all the chunks of a stream. Allocation figures are only filled in when the
+// program counts allocations, see YAMLPP_COUNT_ALLOCATIONS below; the
+// times are always measured. Scan time is the time spent in the grammar
+// itself, build time the time spent storing values into the document and
+// convert time the time spent turning numbers into ints.
+struct ParseStats {
+    ParseStats() : allocations(0), bytes(0), peak_bytes(0), scan_seconds(0), build_seconds(0), convert_seconds(0) {}
+
+    size_t allocations;
+    size_t bytes;
+    size_t peak_bytes;
+    double scan_seconds;
+    double build_seconds;
+    double convert_seconds;
+};
+
+// Counts the allocations made on the current thread while it is alive.
+// Counters nest; only the innermost one is updated.
+class AllocationCounter {
+public:
+    AllocationCounter() : allocations(0), bytes(0), live(0), peak(0), previous(active()) {
+        active() = this;
+    }
+
+    ~AllocationCounter() {
+        active() = previous;
+    }
+
+    void allocated(size_t size) {
+        allocations++;
+        bytes += size;
+        live += static_cast<long>(size);
+        if (live > peak) {
+            peak = live;
+        }
+    }
+
+    // Memory allocated before the counter started may be freed while it
+    // runs, so the live byte count can drop below zero.
+    void deallocated(size_t size) {
+        live -= static_cast<long>(size);
+    }
+
+    static AllocationCounter*& active() {
+        static thread_local AllocationCounter* counter = 0;
+        return counter;
+    }
+
+    size_t allocations;
+    size_t bytes;
+    long live;
+    long peak;
+
+private:
+    AllocationCounter(const AllocationCounter&);
+    AllocationCounter& operator=(const AllocationCounter&);
+
+private:
+    AllocationCounter* previous;
+};
+
+// Adds the lifetime of the timer to seconds, or does nothing if seconds is
+// null, so that disabled timing costs a single branch.
+class PhaseTimer {
+public:
+    explicit PhaseTimer(double* seconds) : seconds(seconds), start() {
+        if (seconds) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~PhaseTimer() {
+        if (seconds) {
+            *seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+private:
+    double* seconds;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Process wide totals. While enabled every Document collects statistics
+// and records them here.
+class ParseStatsRegistry {
+public:
+    static ParseStatsRegistry& global() {
+        static ParseStatsRegistry registry;
+        return registry;
+    }
+
+    bool enabled() const {return is_enabled.load(std::memory_order_relaxed);}
+    void enable(bool enabled) {is_enabled.store(enabled, std::memory_order_relaxed);}
+
+    void record(const ParseStats& stats) {
+        std::lock_guard<std::mutex> lock(mutex);
+        parse_count++;
+        sum.allocations += stats.allocations;
+        sum.bytes += stats.bytes;
+        if (stats.peak_bytes > sum.peak_bytes) {
+            sum.peak_bytes = stats.peak_bytes;
+        }
+        sum.scan_seconds += stats.scan_seconds;
+        sum.build_seconds += stats.build_seconds;
+        sum.convert_seconds += stats.convert_seconds;
+    }
+
+    // Summed over all recorded parses, except for peak_bytes which is the
+    // largest peak of any single parse.
+    ParseStats totals() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sum;
+    }
+
+    size_t parses() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return parse_count;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        parse_count = 0;
+        sum = ParseStats();
+    }
+
+private:
+    ParseStatsRegistry() : is_enabled(false), mutex(), parse_count(0), sum() {}
+
+private:
+    std::atomic<bool> is_enabled;
+    mutable std::mutex mutex;
+    size_t parse_count;
+    ParseStats sum;
+};
+
+// Defining YAMLPP_COUNT_ALLOCATIONS in exactly one translation unit, before
+// any yamlpp header is included, replaces the global operator new and
+// delete with versions that report to the active AllocationCounter.
+#ifdef YAMLPP_COUNT_ALLOCATIONS
+
+namespace yamlpp_allocation {
+    const size_t header = alignof(std::max_align_t);
+}
+
+void* operator new(size_t size) {
+    char* block = static_cast<char*>(std::malloc(size + yamlpp_allocation::header));
+    if (!block) {
+        raiseError(std::bad_alloc());
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    if (AllocationCounter* counter = AllocationCounter::active()) {
+        counter->allocated(size);
+    }
+    return block + yamlpp_allocation::header;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) {
+        return;
+    }
+    // Going through an integer keeps the compiler from treating the header
+    // as outside of the object that operator new returned.
+    char* block = reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(p) - yamlpp_allocation::header);
+    if (AllocationCounter* counter = AllocationCounter::active()) {
+        counter->deallocated(*reinterpret_cast<size_t*>(block));
+    }
+    std::free(block);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+#endif
+
+#endif
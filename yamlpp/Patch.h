@@ -0,0 +1,505 @@
+#ifndef YAMLPP_PATCH_H
+#define YAMLPP_PATCH_H
+
+#include "Document.h"
+#include "Diff.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class PatchException : public std::runtime_error {
+public:
+    explicit PatchException(const std::string& reason) : std::runtime_error(reason) {}
+};
+
+// A JSON pointer split into its keys once, for paths used many times. A
+// key that is a list index is converted as well, and - stands for the end
+// of a list. At the top of a document, - is the document's list, as in
+// the paths Diff reports.
+class CompiledPath {
+public:
+    static const size_t noIndex = static_cast<size_t>(-1);
+    static const size_t endIndex = static_cast<size_t>(-2);
+
+    struct Segment {
+        Segment() : key(), index(noIndex) {}
+
+        std::string key;
+        size_t index;
+    };
+
+    CompiledPath(const std::string& pointer) : pointer(pointer), segments() {compile();}
+    CompiledPath(const char* pointer) : pointer(pointer), segments() {compile();}
+
+    const std::string& str() const {return pointer;}
+
+    size_t size() const {return segments.size();}
+    const Segment& operator[](size_t i) const {return segments[i];}
+
+    // True when that is this path or below it.
+    bool contains(const CompiledPath& that) const {
+        if (that.segments.size() < segments.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < segments.size(); i++) {
+            if (segments[i].key != that.segments[i].key) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the value at the path, through aliases and merged keys, or
+    // null if there is none.
+    const boost::any* find(const Document& document) const {
+        if (segments.empty()) {
+            return 0;
+        }
+        const boost::any* value = segments[0].key == "-" ? documentList(document) : document.find(segments[0].key);
+        for (size_t i = 1; i < segments.size() && value; i++) {
+            const boost::any& container = resolve(*value);
+            if (const Mapping* mapping = boost::any_cast<Mapping>(&container)) {
+                value = mapping->find(segments[i].key);
+            } else if (const List* list = boost::any_cast<List>(&container)) {
+                value = segments[i].index < list->count() ? &(*list)[segments[i].index] : 0;
+            } else {
+                value = 0;
+            }
+        }
+        return value;
+    }
+
+    // Returns the path of the first count keys of this one.
+    CompiledPath prefix(size_t count) const {
+        CompiledPath path(*this);
+        size_t end = 0;
+        for (size_t i = 0; i < count && end != std::string::npos; i++) {
+            end = pointer.find('/', end + 1);
+        }
+        if (end != std::string::npos) {
+            path.pointer.erase(end);
+        }
+        path.segments.resize(count);
+        return path;
+    }
+
+    // Returns this path with its last key replaced by a list index.
+    CompiledPath at(size_t index) const {
+        CompiledPath path(*this);
+        path.segments.back().key = std::to_string(index);
+        path.segments.back().index = index;
+        path.pointer.erase(path.pointer.rfind('/') + 1).append(path.segments.back().key);
+        return path;
+    }
+
+    static const boost::any* documentList(const Document& document) {
+        for (Document::const_iterator it = document.begin(); it != document.end(); it++) {
+            if (it->second.type() == typeid(List)) {
+                return &it->second;
+            }
+        }
+        return 0;
+    }
+
+private:
+    void compile() {
+        if (!pointer.empty() && pointer[0] != '/') {
+            raiseError(PatchException("Path '" + pointer + "' does not start with '/'"));
+        }
+        for (size_t start = 1; start <= pointer.size(); ) {
+            size_t end = std::min(pointer.find('/', start), pointer.size());
+            Segment segment;
+            for (size_t i = start; i < end; i++) {
+                if (pointer[i] != '~') {
+                    segment.key.push_back(pointer[i]);
+                } else if (i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+                    segment.key.push_back(pointer[++i] == '0' ? '~' : '/');
+                } else {
+                    raiseError(PatchException("Path '" + pointer + "' has a ~ that is not followed by 0 or 1"));
+                }
+            }
+            segment.index = index(segment.key);
+            segments.push_back(segment);
+            start = end + 1;
+        }
+    }
+
+    static size_t index(const std::string& key) {
+        if (key == "-") {
+            return endIndex;
+        }
+        if (key.empty() || key.size() > 18 || (key[0] == '0' && key.size() > 1)) {
+            return noIndex;
+        }
+        size_t index = 0;
+        for (std::string::const_iterator it = key.begin(); it != key.end(); it++) {
+            if (*it < '0' || *it > '9') {
+                return noIndex;
+            }
+            index = index * 10 + (*it - '0');
+        }
+        return index;
+    }
+
+private:
+    std::string pointer;
+    std::vector<Segment> segments;
+};
+
+// Changes to a document, made in place, in the manner of a JSON Patch. Build
+// one with the chained calls below and apply it to any number of
+// documents:
+//
+//   Patch patch(Patch().replace("/server/port", 8080).remove("/debug").add("/-/-", std::string("item")));
+//   patch.apply(document);
+//
+// Adding to a list inserts before the index given, or appends for -;
+// adding a key that is there already replaces its value. Only the lists
+// and mappings along a path are touched, and the hashes they cache are
+// cleared. A value reached through an alias or a merged key is copied
+// into place before it is changed, so the anchored or merged mapping stays
+// as it was for everything else that uses it. Undoing a failed patch puts
+// the aliases and merged keys back as well.
+class Patch {
+public:
+    Patch() : ops() {}
+
+    Patch& add(const CompiledPath& path, const boost::any& value) {return push(Add, path, path, value);}
+    Patch& remove(const CompiledPath& path) {return push(Remove, path, path, boost::any());}
+    Patch& replace(const CompiledPath& path, const boost::any& value) {return push(Replace, path, path, value);}
+    Patch& move(const CompiledPath& from, const CompiledPath& path) {return push(Move, path, from, boost::any());}
+
+    size_t size() const {return ops.size();}
+
+    // Applies every change in order. If one cannot be made, those before it
+    // are undone, copies of aliased and merged values included, and
+    // PatchException says why, so the document is either fully patched or
+    // left as it was.
+    void apply(Document& document) const {
+        document.hash_value = 0;
+#ifdef YAMLPP_NO_EXCEPTIONS
+        for (size_t i = 0; i < ops.size(); i++) {
+            run(document, ops[i], 0);
+        }
+#else
+        std::vector<Op> undo;
+        try {
+            for (size_t i = 0; i < ops.size(); i++) {
+                run(document, ops[i], &undo);
+            }
+        } catch (...) {
+            while (!undo.empty()) {
+                run(document, undo.back(), 0);
+                undo.pop_back();
+            }
+            throw;
+        }
+#endif
+    }
+
+    // Returns the patch that turns before into after.
+    static Patch between(const Document& before, const Document& after) {
+        std::vector<Change> changes(Diff::compare(before, after));
+        Patch patch;
+        std::vector<CompiledPath> removedItems;
+        for (size_t i = 0; i < changes.size(); i++) {
+            CompiledPath path(changes[i].path);
+            bool item = path[path.size() - 1].index != CompiledPath::noIndex && path.size() > 1;
+            if (changes[i].kind == Change::Removed && item) {
+                removedItems.push_back(path);
+                continue;
+            }
+            patch.removeItems(removedItems);
+            if (changes[i].kind == Change::Removed) {
+                patch.remove(path);
+            } else {
+                const boost::any& value = *path.find(after);
+                patch.push(changes[i].kind == Change::Added ? Add : Replace, path, path, resolve(value));
+            }
+        }
+        patch.removeItems(removedItems);
+        return patch;
+    }
+
+private:
+    enum Kind {Add, Remove, Replace, Move};
+
+    struct Op {
+        Op(Kind kind, const CompiledPath& path, const CompiledPath& from, const boost::any& value) : kind(kind), path(path), from(from), value(value) {}
+
+        Kind kind;
+        CompiledPath path;
+        CompiledPath from;
+        boost::any value;
+    };
+
+    Patch& push(Kind kind, const CompiledPath& path, const CompiledPath& from, const boost::any& value) {
+        if (!path.size() || !from.size()) {
+            raiseError(PatchException("The whole document cannot be patched"));
+        }
+        const char* const* text = boost::any_cast<const char*>(&value);
+        ops.push_back(Op(kind, path, from, text ? boost::any(std::string(*text)) : value));
+        return *this;
+    }
+
+    // Items removed from the end of a list are removed last first, so that
+    // the indexes of the others stay put.
+    void removeItems(std::vector<CompiledPath>& paths) {
+        while (!paths.empty()) {
+            remove(paths.back());
+            paths.pop_back();
+        }
+    }
+
+    // Makes one change and records in undo how to take it back, with the
+    // list indexes it ended up at. Values copied into place on the way are
+    // recorded first, so that they are put back last.
+    static void run(Document& document, const Op& op, std::vector<Op>* undo) {
+        CompiledPath at(op.path);
+        boost::any old;
+        switch (op.kind) {
+        case Add:
+        case Replace:
+            if (put(document, op.path, op.value, op.kind == Add, at, old, undo)) {
+                record(undo, Replace, at, at, std::move(old));
+            } else {
+                record(undo, Remove, at, at, boost::any());
+            }
+            break;
+        case Remove:
+            old = take(document, op.path, at, undo);
+            record(undo, Add, at, at, std::move(old));
+            break;
+        case Move: {
+            if (op.from.contains(op.path) && op.from.str() != op.path.str()) {
+                raiseError(PatchException("Cannot move " + op.from.str() + " into itself"));
+            }
+            CompiledPath from(op.from);
+            boost::any value(take(document, op.from, from, undo));
+            bool replaced;
+#ifdef YAMLPP_NO_EXCEPTIONS
+            replaced = put(document, op.path, value, true, at, old, undo);
+#else
+            try {
+                replaced = put(document, op.path, value, true, at, old, undo);
+            } catch (...) {
+                put(document, from, value, true, from, old, 0);
+                throw;
+            }
+#endif
+            if (replaced) {
+                record(undo, Add, at, at, std::move(old));
+            }
+            record(undo, Move, from, at, boost::any());
+            break;
+        }
+        }
+    }
+
+    static void record(std::vector<Op>* undo, Kind kind, const CompiledPath& path, const CompiledPath& from, boost::any&& value) {
+        if (undo) {
+            undo->push_back(Op(kind, path, from, boost::any()));
+            undo->back().value = std::move(value);
+        }
+    }
+
+    // Sets the value at path, or inserts it when the path ends in a list
+    // index. Returns true, with the value replaced in old, if there was one.
+    static bool put(Document& document, const CompiledPath& path, const boost::any& value, bool add, CompiledPath& at, boost::any& old,
+                    std::vector<Op>* undo) {
+        const CompiledPath::Segment& last = path[path.size() - 1];
+        if (path.size() == 1) {
+            if (last.key == "-") {
+                return putList(document, path, value, add, old);
+            }
+            return putKey(document, path, value, add, old);
+        }
+        boost::any& container = parent(document, path, undo);
+        if (Mapping* mapping = boost::any_cast<Mapping>(&container)) {
+            return putKey(*mapping, path, value, add, old);
+        }
+        List& list = boost::any_cast<List&>(container);
+        size_t index = last.index == CompiledPath::endIndex ? list.count() : last.index;
+        if (add && index <= list.count()) {
+            list.insert(index, value);
+            at = path.at(index);
+            return false;
+        }
+        if (!add && index < list.count()) {
+            old = std::move(list.modify(index));
+            list.modify(index) = value;
+            return true;
+        }
+        return fail(path, "is past the end of the list");
+    }
+
+    // Takes the value at path out of the document.
+    static boost::any take(Document& document, const CompiledPath& path, CompiledPath& at, std::vector<Op>* undo) {
+        const CompiledPath::Segment& last = path[path.size() - 1];
+        if (path.size() == 1) {
+            if (last.key == "-") {
+                std::map<std::string, boost::any>::iterator it(listEntry(document));
+                if (it == document.values.end()) {
+                    fail(path, "is not there");
+                }
+                boost::any list(std::move(it->second));
+                document.values.erase(it);
+                return list;
+            }
+            return takeKey(document, path);
+        }
+        boost::any& container = parent(document, path, undo);
+        if (Mapping* mapping = boost::any_cast<Mapping>(&container)) {
+            return takeKey(*mapping, path);
+        }
+        List& list = boost::any_cast<List&>(container);
+        if (last.index >= list.count()) {
+            fail(path, "is past the end of the list");
+        }
+        at = path.at(last.index);
+        return list.remove(last.index);
+    }
+
+    static bool putList(Document& document, const CompiledPath& path, const boost::any& value, bool add, boost::any& old) {
+        if (value.type() != typeid(List)) {
+            fail(path, "can only be given a list");
+        }
+        std::map<std::string, boost::any>::iterator it(listEntry(document));
+        if (it != document.values.end()) {
+            old = std::move(it->second);
+            it->second = value;
+            return true;
+        }
+        if (!add) {
+            fail(path, "is not there");
+        }
+        std::string key;
+        Document::timeStamp(key);
+        while (document.values.count(key)) {
+            key.push_back('-');
+        }
+        document.values[key] = value;
+        return false;
+    }
+
+    template<class Container>
+    static bool putKey(Container& container, const CompiledPath& path, const boost::any& value, bool add, boost::any& old) {
+        const std::string& key = path[path.size() - 1].key;
+        if (boost::any* current = ownValue(container, key)) {
+            old = std::move(*current);
+            *current = value;
+            return true;
+        }
+        if (!add && !container.find(key)) {
+            fail(path, "is not there");
+        }
+        setValue(container, key) = value;
+        return false;
+    }
+
+    template<class Container>
+    static boost::any takeKey(Container& container, const CompiledPath& path) {
+        const std::string& key = path[path.size() - 1].key;
+        boost::any* current = ownValue(container, key);
+        if (!current) {
+            fail(path, container.find(key) ? "is merged from another mapping" : "is not there");
+        }
+        boost::any value(std::move(*current));
+        eraseValue(container, key);
+        return value;
+    }
+
+    // Returns the list or mapping the last key of path is in, copying what
+    // is reached through an alias or a merged key into place.
+    static boost::any& parent(Document& document, const CompiledPath& path, std::vector<Op>* undo) {
+        boost::any* value;
+        if (path[0].key == "-") {
+            std::map<std::string, boost::any>::iterator it(listEntry(document));
+            if (it == document.values.end()) {
+                fail(path, "is in a list the document does not have");
+            }
+            value = &it->second;
+        } else {
+            value = &child(document, path, 0, undo);
+        }
+        for (size_t i = 1; i + 1 < path.size(); i++) {
+            boost::any& container = own(*value, path, i, undo);
+            if (Mapping* mapping = boost::any_cast<Mapping>(&container)) {
+                value = &child(*mapping, path, i, undo);
+            } else if (List* list = boost::any_cast<List>(&container)) {
+                if (path[i].index >= list->count()) {
+                    fail(path, "is past the end of a list");
+                }
+                value = &list->modify(path[i].index);
+            } else {
+                fail(path, "goes through a value that is not a list or mapping");
+            }
+        }
+        boost::any& container = own(*value, path, path.size() - 1, undo);
+        if (container.type() != typeid(Mapping) && container.type() != typeid(List)) {
+            fail(path, "goes through a value that is not a list or mapping");
+        }
+        return container;
+    }
+
+    // Returns the value for the key of path at i, copying a merged one
+    // into the container, which undo removes again.
+    template<class Container>
+    static boost::any& child(Container& container, const CompiledPath& path, size_t i, std::vector<Op>* undo) {
+        if (boost::any* value = ownValue(container, path[i].key)) {
+            return *value;
+        }
+        const boost::any* merged = container.find(path[i].key);
+        if (!merged) {
+            fail(path, "goes through a key that is not there");
+        }
+        boost::any copy(*merged);
+        boost::any& value = setValue(container, path[i].key) = std::move(copy);
+        CompiledPath key(path.prefix(i + 1));
+        record(undo, Remove, key, key, boost::any());
+        return value;
+    }
+
+    // Replaces an alias, the value of the first count keys of path, with a
+    // copy of what it stands for. Undo puts the alias back.
+    static boost::any& own(boost::any& value, const CompiledPath& path, size_t count, std::vector<Op>* undo) {
+        if (Alias* alias = boost::any_cast<Alias>(&value)) {
+            boost::any copy(*alias->target);
+            if (undo) {
+                CompiledPath key(path.prefix(count));
+                record(undo, Replace, key, key, std::move(value));
+            }
+            value = std::move(copy);
+        }
+        return value;
+    }
+
+    static std::map<std::string, boost::any>::iterator listEntry(Document& document) {
+        std::map<std::string, boost::any>::iterator it(document.values.begin());
+        while (it != document.values.end() && it->second.type() != typeid(List)) {
+            it++;
+        }
+        return it;
+    }
+
+    static boost::any* ownValue(Document& document, const std::string& key) {
+        std::map<std::string, boost::any>::iterator it(document.values.find(key));
+        return it == document.values.end() ? 0 : &it->second;
+    }
+
+    static boost::any* ownValue(Mapping& mapping, const std::string& key) {return mapping.modify(key);}
+    static boost::any& setValue(Document& document, const std::string& key) {return document.values[key];}
+    static boost::any& setValue(Mapping& mapping, const std::string& key) {return mapping[key];}
+    static void eraseValue(Document& document, const std::string& key) {document.values.erase(key);}
+    static void eraseValue(Mapping& mapping, const std::string& key) {mapping.erase(key);}
+
+    static bool fail(const CompiledPath& path, const std::string& reason) {
+        raiseError(PatchException("Path " + path.str() + " " + reason));
+        return false;
+    }
+
+private:
+    std::vector<Op> ops;
+};
+
+#endif
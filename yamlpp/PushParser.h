@@ -0,0 +1,99 @@
+#ifndef YAMLPP_PUSHPARSER_H
+#define YAMLPP_PUSHPARSER_H
+
+#include "Document.h"
+#include <string>
+
+// Parses a document from input that arrives in pieces. Bytes are kept only
+// until the top level block they belong to is complete, which is known once
+// the next top level line starts; each complete run of blocks is parsed
+// into the document as it arrives. Lines that continue a block, including
+// the lines of a flow mapping, must be indented.
+//
+// Limits apply to everything fed, and error positions are relative to the
+// start of the input. After a run fails to parse, further input is ignored
+// and error() describes the failure.
+class PushParser {
+public:
+    explicit PushParser(Document& document) : document(document), buffer(), failed(false) {
+        document.startStream();
+    }
+
+    // Adds size bytes of input. Returns false once the input has failed to
+    // parse.
+    bool feed(const char* data, size_t size) {
+        if (failed) {
+            return false;
+        }
+        size_t searched = buffer.size();
+        buffer.append(data, size);
+        size_t boundary = lastBoundary(searched);
+        if (boundary) {
+            parse(boundary);
+        }
+        return !failed;
+    }
+
+    // Parses the rest of the input once it has all been fed, and records
+    // the statistics of the whole input. Returns true when the whole input
+    // was parsed.
+    bool finish() {
+        if (!failed) {
+            parse(buffer.size());
+        }
+        document.finishStream();
+        return !failed;
+    }
+
+    const ParseError& error() const {return document.error();}
+
+    // Bytes fed but not parsed yet.
+    size_t pending() const {return buffer.size();}
+
+private:
+    // Returns the start of the last top level line in buffer whose first
+    // byte is at or after from, or 0 if there is none. A line is known to
+    // be top level once its first byte has arrived.
+    size_t lastBoundary(size_t from) const {
+        size_t end = buffer.size();
+        while (end > 0) {
+            size_t newline = buffer.rfind('\n', end - 1);
+            if (newline == std::string::npos || newline + 1 < from) {
+                return 0;
+            }
+            if (newline + 1 < buffer.size() && isTopLevel(buffer[newline + 1])) {
+                return newline + 1;
+            }
+            end = newline;
+        }
+        return 0;
+    }
+
+    static bool isTopLevel(char c) {
+        return c != ' ' && c != '\t' && c != '\r' && c != '\n';
+    }
+
+    void parse(size_t end) {
+        const char* first = buffer.data();
+        const char* last = first + end;
+        if (skipBlank(first, last) != last) {
+            failed = !document.parseChunk(first, last).full;
+        } else {
+            document.skipChunk(first, last);
+        }
+        if (!failed) {
+            buffer.erase(0, end);
+        }
+    }
+
+private:
+    PushParser(const PushParser&);
+    PushParser& operator=(const PushParser&);
+
+private:
+    Document& document;
+    std::string buffer;
+    bool failed;
+};
+
+#endif
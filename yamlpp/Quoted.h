@@ -0,0 +1,156 @@
+#ifndef YAMLPP_QUOTED_H
+#define YAMLPP_QUOTED_H
+
+#include <boost/spirit.hpp>
+#include <cctype>
+#include <cstring>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Returns the first quote or backslash in [p, last), or last.
+inline const char* findQuoteOrEscape(const char* p, const char* last, char quote) {
+#ifdef __SSE2__
+    const __m128i quotes = _mm_set1_epi8(quote);
+    const __m128i escapes = _mm_set1_epi8('\\');
+    while (last - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, escapes)));
+        if (mask) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#endif
+    for (; p != last; p++) {
+        if (*p == quote || *p == '\\') {
+            return p;
+        }
+    }
+    return last;
+}
+
+// Returns the quote that closes the scalar opened at first, or last if it
+// is not closed. Backslash escapes only apply to double quoted scalars;
+// single quoted ones escape a quote by doubling it.
+inline const char* findClosingQuote(const char* first, const char* last) {
+    char quote = *first;
+    const char* p = first + 1;
+    while ((p = findQuoteOrEscape(p, last, quote)) != last) {
+        if (*p == '\\' && quote == '"') {
+            p += p + 1 == last ? 1 : 2;
+        } else if (*p == '\\') {
+            p++;
+        } else if (quote == '\'' && p + 1 != last && p[1] == '\'') {
+            p += 2;
+        } else {
+            return p;
+        }
+    }
+    return last;
+}
+
+// Code points that UTF-8 cannot encode, surrogates and those above
+// U+10FFFF, are appended as U+FFFD, the replacement character, so that
+// decoded scalars are always valid UTF-8.
+inline void appendUtf8(unsigned long code, std::string& out) {
+    if ((code >= 0xd800 && code <= 0xdfff) || code > 0x10ffff) {
+        code = 0xfffd;
+    }
+    if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    }
+}
+
+// Appends the decoded contents of the quoted scalar [first, last), quotes
+// included. Unknown escapes are kept as the escaped character, and escapes
+// of code points that UTF-8 cannot encode decode to U+FFFD.
+inline void unescapeQuoted(const char* first, const char* last, std::string& out) {
+    char quote = *first;
+    const char* p = first + 1;
+    const char* end = last - 1;
+    while (p < end) {
+        const char* special = findQuoteOrEscape(p, end, quote);
+        out.append(p, special);
+        if (special == end) {
+            break;
+        }
+        if (quote == '\'' || *special == quote) {
+            out.push_back(*special);
+            p = special + (*special == '\'' ? 2 : 1);
+            continue;
+        }
+        p = special + 1;
+        if (p == end) {
+            out.push_back('\\');
+            break;
+        }
+        size_t digits = 0;
+        switch (*p) {
+        case '0': out.push_back('\0'); break;
+        case 'a': out.push_back('\a'); break;
+        case 'b': out.push_back('\b'); break;
+        case 't': out.push_back('\t'); break;
+        case 'n': out.push_back('\n'); break;
+        case 'v': out.push_back('\v'); break;
+        case 'f': out.push_back('\f'); break;
+        case 'r': out.push_back('\r'); break;
+        case 'e': out.push_back('\x1b'); break;
+        case 'N': appendUtf8(0x85, out); break;
+        case '_': appendUtf8(0xa0, out); break;
+        case 'L': appendUtf8(0x2028, out); break;
+        case 'P': appendUtf8(0x2029, out); break;
+        case 'x': digits = 2; break;
+        case 'u': digits = 4; break;
+        case 'U': digits = 8; break;
+        default: out.push_back(*p);
+        }
+        p++;
+        if (digits) {
+            unsigned long code = 0;
+            for (; digits > 0 && p < end && std::isxdigit(static_cast<unsigned char>(*p)); digits--, p++) {
+                code = code * 16 + (std::isdigit(static_cast<unsigned char>(*p)) ? *p - '0' : (*p | 0x20) - 'a' + 10);
+            }
+            appendUtf8(code, out);
+        }
+    }
+}
+
+inline bool isQuoted(const char* first, const char* last) {
+    return last - first >= 2 && (*first == '"' || *first == '\'');
+}
+
+// Spirit parser for a single or double quoted scalar, quotes included. Like
+// all functor parsers it advances the scanner itself.
+struct QuotedScalar {
+    typedef boost::spirit::nil_t result_t;
+
+    template<class ScannerT>
+    std::ptrdiff_t operator()(const ScannerT& scan, result_t&) const {
+        if (scan.at_end() || (*scan != '"' && *scan != '\'')) {
+            return -1;
+        }
+        const char* first = scan.first;
+        const char* closing = findClosingQuote(first, scan.last);
+        if (closing == scan.last) {
+            return -1;
+        }
+        scan.first = closing + 1;
+        return closing - first + 1;
+    }
+};
+
+#endif
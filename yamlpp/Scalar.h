@@ -0,0 +1,24 @@
+#ifndef YAMLPP_SCALAR_H
+#define YAMLPP_SCALAR_H
+
+#include "Quoted.h"
+#include "BlockScalar.h"
+
+// Stores the text of a scalar as matched by the grammar into out. Plain and
+// escape free quoted scalars are assigned straight from the input; only
+// scalars with escapes and block scalars are decoded.
+inline void scalarText(const char* first, const char* last, std::string& out) {
+    if (isBlockScalar(first, last)) {
+        out.clear();
+        decodeBlockScalar(first, last, out);
+    } else if (!isQuoted(first, last)) {
+        out.assign(first, last);
+    } else if (findQuoteOrEscape(first + 1, last - 1, *first) == last - 1) {
+        out.assign(first + 1, last - 1);
+    } else {
+        out.clear();
+        unescapeQuoted(first, last, out);
+    }
+}
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef YAMLPP_SCHEMA_H
+#define YAMLPP_SCHEMA_H
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Errors.h"
+
+// Validation rules compiled from a Schema. Keys are found through a hash
+// table, and each rule is a flat record of the accepted value types, the
+// allowed range and the allowed values, so checking a value is a few
+// comparisons. A compiled schema is immutable and can be shared by any
+// number of parses.
+class CompiledSchema {
+public:
+    struct Rule {
+        Rule() : key(), types(0), required(false), min(INT_MIN), max(INT_MAX), choices(), index(0) {}
+
+        std::string key;
+        unsigned types;
+        bool required;
+        int min;
+        int max;
+        std::unordered_set<std::string> choices;
+        size_t index;
+    };
+
+    CompiledSchema() : rules(), index(), item_types(0), is_closed(false) {}
+
+    // Returns the rule for key, or null if the schema does not mention it.
+    const Rule* find(const std::string& key) const {
+        std::unordered_map<std::string, size_t>::const_iterator it(index.find(key));
+        return it == index.end() ? 0 : &rules[it->second];
+    }
+
+    // Returns why a value of the given type is not accepted by rule, or
+    // null if it is. Numbers and text are checked against the range and
+    // the allowed values when given.
+    static const char* check(const Rule& rule, unsigned type, const int* number, const std::string* text) {
+        if (!(rule.types & type)) {
+            return "has the wrong type";
+        }
+        if (number && (*number < rule.min || *number > rule.max)) {
+            return "is out of range";
+        }
+        if (text && !rule.choices.empty() && rule.choices.find(*text) == rule.choices.end()) {
+            return "is not one of the allowed values";
+        }
+        return 0;
+    }
+
+    size_t size() const {return rules.size();}
+    const Rule& rule(size_t i) const {return rules[i];}
+
+    // Accepted types of list items, or 0 if any item is accepted.
+    unsigned itemTypes() const {return item_types;}
+
+    // True when keys the schema does not mention are rejected.
+    bool closed() const {return is_closed;}
+
+private:
+    friend class Schema;
+
+    std::vector<Rule> rules;
+    std::unordered_map<std::string, size_t> index;
+    unsigned item_types;
+    bool is_closed;
+};
+
+// Describes the keys a document may have. Build one with the chained calls
+// below and compile it once before parsing:
+//
+//   CompiledSchema schema(Schema().require("host", Schema::String)
+//       .require("port", Schema::Int).range("port", 1, 65535).compile());
+//   document.parse(data, schema);
+class Schema {
+public:
+    enum Type {String = 1, Int = 2, Map = 4, Any = 7};
+
+    Schema() : keys(), item_types(0), is_closed(false) {}
+
+    Schema& require(const std::string& key, unsigned types) {
+        return declare(key, types, true);
+    }
+
+    Schema& allow(const std::string& key, unsigned types) {
+        return declare(key, types, false);
+    }
+
+    Schema& range(const std::string& key, int min, int max) {
+        CompiledSchema::Rule& rule = declared(key);
+        rule.min = min;
+        rule.max = max;
+        return *this;
+    }
+
+    Schema& oneOf(const std::string& key, const std::vector<std::string>& values) {
+        declared(key).choices.insert(values.begin(), values.end());
+        return *this;
+    }
+
+    Schema& items(unsigned types) {
+        item_types = types;
+        return *this;
+    }
+
+    // Rejects keys that have not been declared.
+    Schema& closed() {
+        is_closed = true;
+        return *this;
+    }
+
+    CompiledSchema compile() const {
+        CompiledSchema compiled;
+        compiled.rules = keys;
+        compiled.index.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            compiled.rules[i].index = i;
+            compiled.index[keys[i].key] = i;
+        }
+        compiled.item_types = item_types;
+        compiled.is_closed = is_closed;
+        return compiled;
+    }
+
+private:
+    Schema& declare(const std::string& key, unsigned types, bool required) {
+        CompiledSchema::Rule rule;
+        rule.key = key;
+        rule.types = types;
+        rule.required = required;
+        keys.push_back(rule);
+        return *this;
+    }
+
+    CompiledSchema::Rule& declared(const std::string& key) {
+        for (std::vector<CompiledSchema::Rule>::iterator it = keys.begin(); it != keys.end(); it++) {
+            if (it->key == key) {
+                return *it;
+            }
+        }
+        raiseError(std::invalid_argument("Key '" + key + "' has not been declared"));
+    }
+
+private:
+    std::vector<CompiledSchema::Rule> keys;
+    unsigned item_types;
+    bool is_closed;
+};
+
+// Thrown when a document does not match its schema. Line and column are
+// counted from one and point at the offending key or value, or at the end
+// of the input for missing keys.
+class ValidationException : public std::runtime_error {
+public:
+    ValidationException(const std::string& reason, size_t line, size_t column)
+    : std::runtime_error(reason + " at line " + std::to_string(line) + ", column " + std::to_string(column) + "."), error_line(line),
+    error_column(column) {}
+
+    size_t line() const {return error_line;}
+    size_t column() const {return error_column;}
+
+private:
+    size_t error_line;
+    size_t error_column;
+};
+
+#endif
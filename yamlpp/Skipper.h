@@ -0,0 +1,84 @@
+#ifndef YAMLPP_SKIPPER_H
+#define YAMLPP_SKIPPER_H
+
+#include <boost/spirit.hpp>
+#include <boost/function.hpp>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Returns the first byte in [p, last) that is not a space, tab or line
+// break, or last. Whitespace is classified sixteen bytes at a time.
+inline const char* skipWhitespace(const char* p, const char* last) {
+#ifdef __SSE2__
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i tabs = _mm_set1_epi8('\t');
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const __m128i returns = _mm_set1_epi8('\r');
+    while (last - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, spaces), _mm_cmpeq_epi8(chunk, tabs)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(chunk, newlines), _mm_cmpeq_epi8(chunk, returns)));
+        int mask = ~_mm_movemask_epi8(blank) & 0xffff;
+        if (mask) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#endif
+    while (p != last && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+// Returns the first byte in [p, last) that is neither whitespace nor part
+// of a # comment. Comment lines are found with memchr. When a callback is
+// given it receives the text of every comment, without the # and the line
+// break.
+inline const char* skipBlank(const char* p, const char* last, boost::function2<void, const char*, const char*>* comment = 0) {
+    p = skipWhitespace(p, last);
+    while (p != last && *p == '#') {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', last - p));
+        const char* end = newline ? newline : last;
+        if (comment) {
+            (*comment)(p + 1, end[-1] == '\r' ? end - 1 : end);
+        }
+        p = skipWhitespace(end, last);
+    }
+    return p;
+}
+
+// Spirit skip parser for whitespace and # comments, used in place of
+// space_p so that a whole run of blanks and comment lines is skipped in one
+// call. Spirit may skip the same comment again after backtracking, so the
+// comment callback has to tell repeats apart by their position.
+struct Skipper {
+    typedef boost::spirit::nil_t result_t;
+
+    explicit Skipper(boost::function2<void, const char*, const char*>* comment = 0) : comment(comment) {}
+
+    template<class ScannerT>
+    std::ptrdiff_t operator()(const ScannerT& scan, result_t&) const {
+        const char* first = scan.first;
+        const char* p = skipBlank(first, scan.last, comment);
+        if (p == first) {
+            return -1;
+        }
+        scan.first = p;
+        return p - first;
+    }
+
+    boost::function2<void, const char*, const char*>* comment;
+};
+
+// Counts blanks and comments after the last line as part of a full parse.
+inline boost::spirit::parse_info<> skipTrailingBlank(boost::spirit::parse_info<> info, const char* last) {
+    if (info.hit && !info.full && skipBlank(info.stop, last) == last) {
+        return boost::spirit::parse_info<>(last, true, true, info.length + (last - info.stop));
+    }
+    return info;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef YAMLPP_UTF8_H
+#define YAMLPP_UTF8_H
+
+#include <cstring>
+#include <boost/cstdint.hpp>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Returns a pointer to the first byte of [first, last) that does not belong
+// to a well formed UTF-8 sequence, or last if the whole range is valid.
+// Runs of ASCII are skipped sixteen bytes at a time; multibyte sequences
+// are checked against tables of the allowed byte ranges, which rejects
+// overlong encodings, surrogates and code points above U+10FFFF.
+inline const char* validateUtf8(const char* first, const char* last) {
+    // Sequence length by lead byte, 0 for bytes that cannot start one.
+    static const unsigned char lengths[256] = {
+        1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+        1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+        1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+        1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+        0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+        0,0,2,2,2,2,2,2,2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,2,
+        3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3, 4,4,4,4,4,0,0,0,0,0,0,0,0,0,0,0
+    };
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(first);
+    const unsigned char* end = reinterpret_cast<const unsigned char*>(last);
+    while (p != end) {
+#ifdef __SSE2__
+        while (end - p >= 16 && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) == 0) {
+            p += 16;
+        }
+#else
+        boost::uint64_t word;
+        while (end - p >= 8 && (std::memcpy(&word, p, 8), (word & 0x8080808080808080ULL) == 0)) {
+            p += 8;
+        }
+#endif
+        if (p == end) {
+            break;
+        }
+        unsigned char lead = *p;
+        unsigned int length = lengths[lead];
+        if (length == 1) {
+            p++;
+            continue;
+        }
+        if (length == 0 || end - p < static_cast<long>(length)) {
+            return reinterpret_cast<const char*>(p);
+        }
+        // The second byte's range depends on the lead byte; the rest are
+        // plain continuation bytes.
+        unsigned char low = 0x80, high = 0xbf;
+        switch (lead) {
+        case 0xe0: low = 0xa0; break;
+        case 0xed: high = 0x9f; break;
+        case 0xf0: low = 0x90; break;
+        case 0xf4: high = 0x8f; break;
+        }
+        if (p[1] < low || p[1] > high) {
+            return reinterpret_cast<const char*>(p);
+        }
+        for (unsigned int i = 2; i < length; i++) {
+            if ((p[i] & 0xc0) != 0x80) {
+                return reinterpret_cast<const char*>(p);
+            }
+        }
+        p += length;
+    }
+    return last;
+}
+
+#endif